@@ -6,10 +6,14 @@
  * 
  * Header-Only C 库，用于向 sys-Notification 系统模块请求向switch发送弹窗
  * 
+ * 库的全局状态在头文件中定义为弱符号，多个源文件包含时链接后只有一份，直接包含即可使用；
+ * 也可以在一个源文件中包含之前 #define LIBNOTIFICATION_IMPLEMENTATION，把全局状态定义在这个源文件中（可选）
+ * 
  * @section 依赖
  * - sys-Notification系统模块
  * - pmdmnt 服务（检查系统模块状态）
  * - pmshell 服务（启动系统模块）
+ * - 命名端口 notif:u（系统模块运行中时通过 IPC 投递通知）
  * 
  * @section 使用示例
  * @code
@@ -45,13 +49,233 @@
 extern "C" {
 #endif
 
-#include <switch.h>
-#include <stdio.h>
-#include <stdlib.h>
+// 协议定义只依赖 C 标准头文件，系统模块的请求分发可在主机上编译测试
+#include <stdint.h>
+#include <stddef.h>
 #include <string.h>
-#include <sys/stat.h>
-#include <dirent.h>
-#include <errno.h>
+#include <stdbool.h>
+
+// ---------------------------------------------------------------------------
+// 共享内存多生产者单消费者环形缓冲区（客户端与系统模块共用）
+// 只依赖 C 标准头文件和 GCC __atomic 内建函数，可在 Linux 上编译测试
+//
+// 每个槽位带一个序号：
+// - 生产者用 CAS 抢占写入位置，写完记录后发布序号
+// - 消费者只读取序号已发布的槽位，读完后把序号推进一圈供下一轮写入
+// - 写入位置的最高位为关闭标志，关闭后生产者无法再抢占位置
+// - 消费者休眠前设置等待标志，生产者只在环从空变为非空时唤醒消费者
+// ---------------------------------------------------------------------------
+
+#define NOTIF_RING_MAGIC        0x474E5252   // "RRNG"
+#define NOTIF_RING_VERSION      1
+#define NOTIF_RING_CAPACITY     32           // 槽位数（2 的幂）
+#define NOTIF_RING_RECORD_SIZE  48           // 每条记录字节数
+#define NOTIF_RING_SHMEM_SIZE   0x1000       // 共享内存大小（页对齐）
+
+#define NOTIF_RING_CLOSED_BIT   0x80000000u  // 写入位置中的关闭标志
+#define NOTIF_RING_POS_MASK     0x7FFFFFFFu  // 位置和序号在 31 位内回绕
+
+/**
+ * @brief 写入结果
+ */
+typedef enum {
+    NOTIF_RING_PUSHED = 0,   // 写入成功
+    NOTIF_RING_FULL = 1,     // 环已满
+    NOTIF_RING_CLOSED = 2    // 消费者已关闭环
+} NotifRingPushResult;
+
+/**
+ * @brief 槽位（64 字节）
+ */
+typedef struct {
+    uint32_t sequence;                        // 序号：等于位置时可写，等于位置 + 1 时可读
+    uint32_t reserved[3];
+    uint8_t data[NOTIF_RING_RECORD_SIZE];     // 记录内容
+} NotifRingSlot;
+
+/**
+ * @brief 环形缓冲区（位于共享内存中，生产者和消费者的位置分属不同缓存行）
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t reserved0[14];
+    uint32_t enqueue_pos;                     // 生产者写入位置（最高位为关闭标志）
+    uint32_t reserved1[15];
+    uint32_t dequeue_pos;                     // 消费者读取位置
+    uint32_t consumer_waiting;                // 消费者准备休眠，生产者写入后需要唤醒
+    uint32_t reserved2[14];
+    NotifRingSlot slots[NOTIF_RING_CAPACITY];
+} NotifRing;
+
+typedef char _notif_ring_size_check[(sizeof(NotifRing) <= NOTIF_RING_SHMEM_SIZE) ? 1 : -1];
+
+/**
+ * @brief 31 位序号差（带符号）
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline int32_t _notif_ring_diff(uint32_t a, uint32_t b) {
+    return (int32_t)((a - b) << 1) >> 1;
+}
+
+/**
+ * @brief 初始化环（消费者调用一次）
+ * @param ring 环
+ */
+static inline void notif_ring_init(NotifRing* ring) {
+    memset(ring, 0, sizeof(*ring));
+    ring->magic = NOTIF_RING_MAGIC;
+    ring->version = NOTIF_RING_VERSION;
+    for (uint32_t i = 0; i < NOTIF_RING_CAPACITY; i++) ring->slots[i].sequence = i;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief 检查映射到的内存是否为有效的环
+ * @param ring 环
+ * @return true 有效, false 无效
+ */
+static inline bool notif_ring_valid(const NotifRing* ring) {
+    return ring->magic == NOTIF_RING_MAGIC && ring->version == NOTIF_RING_VERSION;
+}
+
+/**
+ * @brief 写入一条记录（多生产者，无锁）
+ * @param ring 环
+ * @param record 记录（NOTIF_RING_RECORD_SIZE 字节）
+ * @param out_wake 输出：需要唤醒消费者时为 true
+ * @return NotifRingPushResult 写入结果
+ */
+static inline NotifRingPushResult notif_ring_push(NotifRing* ring, const void* record, bool* out_wake) {
+    *out_wake = false;
+    
+    uint32_t pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+    NotifRingSlot* slot;
+    
+    // 抢占写入位置
+    for (;;) {
+        if (pos & NOTIF_RING_CLOSED_BIT) return NOTIF_RING_CLOSED;
+        
+        slot = &ring->slots[pos & (NOTIF_RING_CAPACITY - 1)];
+        uint32_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int32_t diff = _notif_ring_diff(seq, pos);
+        
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->enqueue_pos, &pos, (pos + 1) & NOTIF_RING_POS_MASK,
+                                            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            return NOTIF_RING_FULL;  // 槽位还未被消费者读走
+        } else {
+            pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+    
+    // 写入记录并发布序号
+    memcpy(slot->data, record, NOTIF_RING_RECORD_SIZE);
+    __atomic_store_n(&slot->sequence, (pos + 1) & NOTIF_RING_POS_MASK, __ATOMIC_RELEASE);
+    
+    // 消费者准备休眠时才唤醒（与 notif_ring_prepare_wait 配对的屏障）
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->consumer_waiting, __ATOMIC_RELAXED) &&
+        __atomic_exchange_n(&ring->consumer_waiting, 0, __ATOMIC_RELAXED)) {
+        *out_wake = true;
+    }
+    
+    return NOTIF_RING_PUSHED;
+}
+
+/**
+ * @brief 取得最早的已发布记录（单消费者）
+ * @param ring 环
+ * @return 记录指针，没有已发布的记录返回 NULL
+ */
+static inline const void* notif_ring_front(NotifRing* ring) {
+    uint32_t pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED) & NOTIF_RING_POS_MASK;
+    NotifRingSlot* slot = &ring->slots[pos & (NOTIF_RING_CAPACITY - 1)];
+    uint32_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+    
+    if (seq != ((pos + 1) & NOTIF_RING_POS_MASK)) return NULL;
+    return slot->data;
+}
+
+/**
+ * @brief 移除 notif_ring_front 返回的记录，槽位交还给生产者（单消费者）
+ * @param ring 环
+ */
+static inline void notif_ring_pop(NotifRing* ring) {
+    uint32_t pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED) & NOTIF_RING_POS_MASK;
+    NotifRingSlot* slot = &ring->slots[pos & (NOTIF_RING_CAPACITY - 1)];
+    
+    __atomic_store_n(&slot->sequence, (pos + NOTIF_RING_CAPACITY) & NOTIF_RING_POS_MASK, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->dequeue_pos, (pos + 1) & NOTIF_RING_POS_MASK, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 已抢占但未被消费的记录数（包括生产者尚未发布的）
+ * @param ring 环
+ * @return 记录数
+ */
+static inline uint32_t notif_ring_size(NotifRing* ring) {
+    uint32_t enq = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_ACQUIRE) & NOTIF_RING_POS_MASK;
+    uint32_t deq = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED) & NOTIF_RING_POS_MASK;
+    return (enq - deq) & NOTIF_RING_POS_MASK;
+}
+
+/**
+ * @brief 检查已抢占的位置是否都已发布（有生产者正在写入时返回 false）
+ * @param ring 环
+ * @return true 没有写入中的记录, false 有生产者尚未发布
+ */
+static inline bool notif_ring_settled(NotifRing* ring) {
+    uint32_t enq = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_ACQUIRE) & NOTIF_RING_POS_MASK;
+    uint32_t pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED) & NOTIF_RING_POS_MASK;
+    
+    for (uint32_t i = 0; i < NOTIF_RING_CAPACITY && pos != enq; i++, pos = (pos + 1) & NOTIF_RING_POS_MASK) {
+        uint32_t seq = __atomic_load_n(&ring->slots[pos & (NOTIF_RING_CAPACITY - 1)].sequence, __ATOMIC_ACQUIRE);
+        if (seq != ((pos + 1) & NOTIF_RING_POS_MASK)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 消费者准备休眠：设置等待标志后再次检查
+ * @param ring 环
+ * @return true 仍为空，可以休眠（有新记录时生产者会唤醒）, false 已有记录，不应休眠
+ */
+static inline bool notif_ring_prepare_wait(NotifRing* ring) {
+    __atomic_store_n(&ring->consumer_waiting, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    
+    if (notif_ring_front(ring) != NULL) {
+        __atomic_store_n(&ring->consumer_waiting, 0, __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 消费者醒来后清除等待标志
+ * @param ring 环
+ */
+static inline void notif_ring_cancel_wait(NotifRing* ring) {
+    __atomic_store_n(&ring->consumer_waiting, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 关闭环：之后的写入返回 NOTIF_RING_CLOSED，已写入的记录仍可读取
+ * @param ring 环
+ */
+static inline void notif_ring_close(NotifRing* ring) {
+    __atomic_fetch_or(&ring->enqueue_pos, NOTIF_RING_CLOSED_BIT, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief 重新开放已关闭的环
+ * @param ring 环
+ */
+static inline void notif_ring_reopen(NotifRing* ring) {
+    __atomic_fetch_and(&ring->enqueue_pos, NOTIF_RING_POS_MASK, __ATOMIC_SEQ_CST);
+}
 
 // sys-Notification 的 Program ID
 #define NOTIF_SYSMODULE_TID 0x0100000000251020ULL
@@ -65,6 +289,155 @@ extern "C" {
 // 通知配置文件路径前缀
 #define _NOTIF_FILE_PREFIX "/config/sys-Notification/notif_"
 
+// 投递日志路径（日志模式下追加写入，系统模块读完后改名轮转并删除）
+#define _NOTIF_SPOOL_PATH "/config/sys-Notification/spool.bin"
+
+// IPC 命名端口名（系统模块运行期间注册，未注册时连接立即失败）
+#define NOTIF_SERVICE_NAME "notif:u"
+
+// IPC 命令号
+#define NOTIF_CMD_POST      0   // 投递一条通知（NotifPostRequest）
+#define NOTIF_CMD_OPEN_RING 1   // 取得共享内存环和唤醒事件的句柄
+
+// IPC 服务返回的错误码（编码与 libnx 的 MAKERESULT 相同）
+#define NOTIF_RESULT_MODULE        251
+#define _NOTIF_MAKERESULT(desc)    ((uint32_t)NOTIF_RESULT_MODULE | ((uint32_t)(desc) << 9))
+#define NOTIF_RESULT_INVALID_ARG   _NOTIF_MAKERESULT(1)   // 请求参数无效
+#define NOTIF_RESULT_QUEUE_FULL    _NOTIF_MAKERESULT(2)   // 待显示队列已满
+#define NOTIF_RESULT_UNKNOWN_CMD   _NOTIF_MAKERESULT(3)   // 未知命令
+#define NOTIF_RESULT_UNAVAILABLE   _NOTIF_MAKERESULT(4)   // 共享内存环不可用
+
+/**
+ * @brief Post 命令的请求体（定长，系统模块与本库共用）
+ */
+typedef struct {
+    char text[32];        // 通知文本（UTF-8，以 '\0' 结尾）
+    uint32_t type;        // 通知类型 (INFO / ERROR)
+    uint32_t position;    // 通知位置 (LEFT / MIDDLE / RIGHT)
+    uint32_t duration;    // 显示时长（秒，范围 1-10）
+    uint32_t reserved;    // 保留，填 0
+} NotifPostRequest;
+
+// 共享内存环中的记录即 NotifPostRequest
+typedef char _notif_post_request_size_check[(sizeof(NotifPostRequest) == NOTIF_RING_RECORD_SIZE) ? 1 : -1];
+
+// 追加式投递日志（spool）的记录标识 "NSPL"
+#define NOTIF_SPOOL_MAGIC 0x4C50534EU
+
+/**
+ * @brief 投递日志中的一条记录（定长 64 字节，客户端一次写入追加到日志末尾）
+ * @note 系统模块按 magic 和校验和识别记录，写到一半的记录会被跳过
+ */
+typedef struct {
+    uint32_t magic;              // NOTIF_SPOOL_MAGIC
+    uint32_t checksum;           // tick 和 request 的 FNV-1a 校验和
+    uint64_t tick;               // 投递时的系统时钟
+    NotifPostRequest request;    // 请求体
+} NotifSpoolRecord;
+
+typedef char _notif_spool_record_size_check[(sizeof(NotifSpoolRecord) == 64) ? 1 : -1];
+
+// 二进制通知记录（.ntf 文件）：定长头部之后是若干类型化字段，系统模块原地读取，不做字符串解析
+#define NOTIF_RECORD_MAGIC     0x46544E4EU   // "NNTF"
+#define NOTIF_RECORD_VERSION   1             // 不兼容的格式变更才增加；新增字段不需要
+#define NOTIF_RECORD_MAX_SIZE  255           // 记录最大字节数（系统模块的文件读取缓冲区）
+
+// 字段类型（系统模块跳过不认识的字段）
+#define NOTIF_FIELD_TEXT       1   // 通知文本（UTF-8，长度由字段大小给出，不要求 '\0' 结尾）
+#define NOTIF_FIELD_TYPE       2   // uint32_t 通知类型 (INFO / ERROR)
+#define NOTIF_FIELD_POSITION   3   // uint32_t 通知位置 (LEFT / MIDDLE / RIGHT)
+#define NOTIF_FIELD_DURATION   4   // uint32_t 显示时长（秒）
+
+/**
+ * @brief 二进制通知记录头部（小端）
+ */
+typedef struct {
+    uint32_t magic;        // NOTIF_RECORD_MAGIC
+    uint16_t version;      // NOTIF_RECORD_VERSION
+    uint16_t length;       // 记录总字节数（含头部）
+    uint32_t flags;        // 保留，填 0
+    uint32_t reserved;     // 保留，填 0
+    uint64_t timestamp;    // 投递时的系统时钟
+} NotifRecordHeader;
+
+/**
+ * @brief 字段头部，之后是 size 字节的字段值，下一个字段从 4 字节对齐处开始
+ */
+typedef struct {
+    uint16_t id;      // NOTIF_FIELD_*
+    uint16_t size;    // 字段值字节数
+} NotifRecordField;
+
+typedef char _notif_record_header_size_check[(sizeof(NotifRecordHeader) == 24) ? 1 : -1];
+
+/**
+ * @brief 检查记录头部并返回记录长度
+ * @param data 记录起始地址
+ * @param size 可用字节数
+ * @return 记录总字节数，头部无效返回 0
+ */
+static inline uint32_t notif_record_length(const void* data, size_t size) {
+    NotifRecordHeader header;
+    if (size < sizeof(header)) return 0;
+    memcpy(&header, data, sizeof(header));
+    
+    if (header.magic != NOTIF_RECORD_MAGIC || header.version != NOTIF_RECORD_VERSION) return 0;
+    if (header.length < sizeof(header) || header.length > size) return 0;
+    return header.length;
+}
+
+/**
+ * @brief 遍历记录中的字段（不拷贝字段值）
+ * @param data 记录起始地址（已通过 notif_record_length 检查）
+ * @param length 记录总字节数
+ * @param offset 输入输出：当前位置，首次调用前置为 0
+ * @param out_field 输出：字段头部
+ * @return 字段值地址，没有更多字段或字段越界返回 NULL
+ */
+static inline const void* notif_record_next_field(const void* data, uint32_t length, uint32_t* offset, NotifRecordField* out_field) {
+    uint32_t pos = (*offset < sizeof(NotifRecordHeader)) ? (uint32_t)sizeof(NotifRecordHeader) : *offset;
+    if (pos + sizeof(NotifRecordField) > length) return NULL;
+    
+    memcpy(out_field, (const uint8_t*)data + pos, sizeof(NotifRecordField));
+    uint32_t value = pos + (uint32_t)sizeof(NotifRecordField);
+    if (value + out_field->size > length) return NULL;
+    
+    *offset = (value + out_field->size + 3) & ~3U;
+    return (const uint8_t*)data + value;
+}
+
+/**
+ * @brief 计算投递日志记录的校验和（覆盖 checksum 之后的全部字段）
+ * @param record 记录
+ * @return 32 位 FNV-1a 校验和
+ */
+static inline uint32_t notif_spool_checksum(const NotifSpoolRecord* record) {
+    const uint8_t* p = (const uint8_t*)&record->tick;
+    const uint8_t* end = (const uint8_t*)record + sizeof(NotifSpoolRecord);
+    uint32_t hash = 2166136261U;
+    while (p < end) {
+        hash ^= *p++;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+// 系统模块只使用上面的协议定义
+#ifndef LIBNOTIFICATION_PROTOCOL_ONLY
+
+#include <switch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+
+// 库的全局状态默认定义为弱符号，每个包含本头文件的源文件都带一份，链接时合并为一份
+#ifdef LIBNOTIFICATION_IMPLEMENTATION
+#define _NOTIF_SHARED
+#else
+#define _NOTIF_SHARED __attribute__((weak))
+#endif
 
 /**
  * @brief 通知类型
@@ -186,36 +559,314 @@ static inline bool _notif_ensure_dir(void) {
 }
 
 /**
- * @brief 生成随机通知配置文件路径（临时文件）
+ * @brief 进程内的通知文件计数（整个程序共用一份，在全局锁内递增）
+ * @warning 这是内部变量，用户不应直接使用
+ */
+_NOTIF_SHARED u32 _notif_file_counter = 0;
+
+/**
+ * @brief 生成带投递序号的通知记录文件路径（临时文件）
  * @param out_path 输出：文件路径缓冲区
  * @param size 缓冲区大小
+ * @note 文件名为 notif_<系统时钟>_<进程ID>_<进程内计数>.ntf（十六进制），
+ *       系统模块按这三项排序，先投递的先显示，不同进程之间也不会重名
  * @warning 这是内部函数，用户不应直接调用
  */
-static inline void _notif_random_path(char* out_path, size_t size) {
-    static bool initialized = false;
+static inline void _notif_sequenced_path(char* out_path, size_t size) {
+    u64 pid = 0;
+    svcGetProcessId(&pid, CUR_PROCESS_HANDLE);
     
-    if (!initialized) {
-        // 使用系统时钟作为种子
-        srand((unsigned int)armGetSystemTick());
-        initialized = true;
-    }
+    snprintf(out_path, size, "%s%016llx_%llx_%x.ntf.temp", _NOTIF_FILE_PREFIX,
+             (unsigned long long)armGetSystemTick(), (unsigned long long)pid, (unsigned int)_notif_file_counter++);
+}
+
+/**
+ * @brief 向记录追加一个字段
+ * @param buf 记录缓冲区
+ * @param capacity 缓冲区大小
+ * @param length 输入输出：当前记录长度
+ * @param id 字段类型
+ * @param value 字段值
+ * @param size 字段值字节数
+ * @return true 成功, false 缓冲区不足
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline bool _notif_record_put(u8* buf, size_t capacity, u32* length, u16 id, const void* value, u16 size) {
+    u32 pos = (*length + 3) & ~3U;
+    if (pos + sizeof(NotifRecordField) + size > capacity) return false;
+    
+    // 对齐填充清零
+    memset(buf + *length, 0, pos - *length);
     
-    u32 random = (u32)(rand() % 100000000);  // 限制到 8 位数（0-99999999）
-    snprintf(out_path, size, "%s%u.ini.temp", _NOTIF_FILE_PREFIX, random);
+    NotifRecordField field = { id, size };
+    memcpy(buf + pos, &field, sizeof(field));
+    memcpy(buf + pos + sizeof(field), value, size);
+    *length = pos + (u32)sizeof(field) + size;
+    return true;
 }
 
 /**
- * @brief 发送通知
- * @param text 通知文本
- * @param duration 显示时长（秒，范围 1-10）
+ * @brief 编码一条二进制通知记录（.ntf 文件内容）
+ * @param buf 输出缓冲区（NOTIF_RECORD_MAX_SIZE 字节即可容纳任何记录）
+ * @param capacity 缓冲区大小
+ * @param text 通知文本（UTF-8，不要求 '\0' 结尾）
+ * @param text_len 文本字节数（不限于 IPC 请求体的 31 字节，记录总长不超过 NOTIF_RECORD_MAX_SIZE 即可）
  * @param type 通知类型 (INFO / ERROR)
  * @param position 通知位置 (LEFT / MIDDLE / RIGHT)
+ * @param duration 显示时长（秒）
+ * @return 记录字节数，缓冲区不足（文本过长）返回 0
+ */
+static inline size_t notifEncodeRecord(void* buf, size_t capacity,
+                                       const char* text, size_t text_len,
+                                       NotificationType type,
+                                       NotificationPosition position,
+                                       int duration) {
+    u8* out = (u8*)buf;
+    if (capacity > NOTIF_RECORD_MAX_SIZE) capacity = NOTIF_RECORD_MAX_SIZE;
+    if (capacity < sizeof(NotifRecordHeader) || !text || text_len > NOTIF_RECORD_MAX_SIZE) return 0;
+    
+    u32 type_value = (u32)type;
+    u32 position_value = (u32)position;
+    u32 duration_value = (u32)duration;
+    u32 length = sizeof(NotifRecordHeader);
+    
+    if (!_notif_record_put(out, capacity, &length, NOTIF_FIELD_TEXT, text, (u16)text_len) ||
+        !_notif_record_put(out, capacity, &length, NOTIF_FIELD_TYPE, &type_value, sizeof(u32)) ||
+        !_notif_record_put(out, capacity, &length, NOTIF_FIELD_POSITION, &position_value, sizeof(u32)) ||
+        !_notif_record_put(out, capacity, &length, NOTIF_FIELD_DURATION, &duration_value, sizeof(u32))) {
+        return 0;
+    }
+    
+    NotifRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = NOTIF_RECORD_MAGIC;
+    header.version = NOTIF_RECORD_VERSION;
+    header.length = (u16)length;
+    header.timestamp = armGetSystemTick();
+    memcpy(out, &header, sizeof(header));
+    return length;
+}
+
+/**
+ * @brief 投递日志模式开关（整个程序共用一份）
+ * @warning 这是内部变量，用户不应直接使用
+ */
+_NOTIF_SHARED bool _notif_spool_enabled = false;
+
+/**
+ * @brief 设置投递日志模式（默认关闭）
+ * @param enabled true=系统模块未运行时把通知追加到同一个日志文件，
+ *                false=每条通知写一个文件
+ * @note 日志模式下每条通知只有一次追加写入，没有文件创建、重命名和删除，
+ *       适合频繁在系统模块未运行时投递的场景；追加失败时改为写通知文件
+ * @note 开关对整个程序生效（所有源文件共用）
+ */
+static inline void notifSetSpoolMode(bool enabled) {
+    _notif_spool_enabled = enabled;
+}
+
+/**
+ * @brief 把通知追加到投递日志（一次写入整条记录）
+ * @param request 请求体
  * @return Result 0=成功，负数=失败
+ * @warning 这是内部函数，用户不应直接调用
  */
-static inline Result createNotification(const char* text, 
-                                        int duration,
-                                        NotificationType type, 
-                                        NotificationPosition position) {
+static inline Result _notif_spool_post(const NotifPostRequest* request) {
+    NotifSpoolRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = NOTIF_SPOOL_MAGIC;
+    record.tick = armGetSystemTick();
+    record.request = *request;
+    record.checksum = notif_spool_checksum(&record);
+    
+    FILE* f = fopen(_NOTIF_SPOOL_PATH, "ab");
+    if (!f) return -3;
+    
+    // 不缓冲，整条记录由一次写入完成
+    setvbuf(f, NULL, _IONBF, 0);
+    size_t written = fwrite(&record, sizeof(record), 1, f);
+    
+    if (fclose(f) != 0 || written != 1) return -3;
+    return 0;
+}
+
+/**
+ * @brief 连接 IPC 服务（系统模块未运行时立即失败）
+ * @param srv 输出：服务会话
+ * @return Result 0=成功，失败=端口未注册或会话已满
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline Result _notif_open_service(Service* srv) {
+    // 命名端口不经过 sm：未注册时内核直接返回 NotFound，不会像 smGetService 那样等待注册
+    Handle session;
+    Result rc = svcConnectToNamedPort(&session, NOTIF_SERVICE_NAME);
+    if (R_FAILED(rc)) return rc;
+    
+    serviceCreate(srv, session);
+    return 0;
+}
+
+/**
+ * @brief 通过 IPC 服务投递通知（系统模块运行中时可用，不写 SD 卡）
+ * @param request 请求体
+ * @return Result 0=成功，失败时应回退到文件投递
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline Result _notif_ipc_post(const NotifPostRequest* request) {
+    Service srv;
+    Result rc = _notif_open_service(&srv);
+    if (R_FAILED(rc)) return rc;
+    
+    rc = serviceDispatchIn(&srv, NOTIF_CMD_POST, *request);
+    serviceClose(&srv);
+    return rc;
+}
+
+/**
+ * @brief 共享内存环的客户端状态（每个进程映射一次）
+ * @warning 这是内部结构，用户不应直接使用
+ */
+typedef struct {
+    Mutex mutex;           // 保护映射、写入和解除映射，其他线程不会写入已解除映射的环
+    SharedMemory shmem;    // 系统模块创建的共享内存
+    Handle wake;           // 唤醒事件（写端）
+    NotifRing* ring;       // 映射后的环，未映射时为 NULL
+} _NotifRingClient;
+
+/**
+ * @brief 共享内存环的客户端状态（整个程序共用一份，所有源文件投递到同一次映射）
+ * @warning 这是内部变量，用户不应直接使用
+ */
+_NOTIF_SHARED _NotifRingClient _notif_ring_client;
+
+/**
+ * @brief 解除共享内存环映射（系统模块退出后调用）
+ * @param client 客户端状态
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline void _notif_ring_unmap(_NotifRingClient* client) {
+    shmemClose(&client->shmem);
+    svcCloseHandle(client->wake);
+    client->ring = NULL;
+}
+
+/**
+ * @brief 通过 IPC 取得共享内存环和唤醒事件并映射
+ * @param client 客户端状态
+ * @return Result 0=成功，负数=失败
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline Result _notif_ring_map(_NotifRingClient* client) {
+    Service srv;
+    Result rc = _notif_open_service(&srv);
+    if (R_FAILED(rc)) return rc;
+    
+    Handle handles[2];
+    rc = serviceDispatch(&srv, NOTIF_CMD_OPEN_RING,
+        .out_handle_attrs = { SfOutHandleAttr_HipcCopy, SfOutHandleAttr_HipcCopy },
+        .out_handles = handles,
+    );
+    serviceClose(&srv);
+    if (R_FAILED(rc)) return rc;
+    
+    shmemLoadRemote(&client->shmem, handles[0], NOTIF_RING_SHMEM_SIZE, Perm_Rw);
+    client->wake = handles[1];
+    
+    rc = shmemMap(&client->shmem);
+    if (R_FAILED(rc)) {
+        shmemClose(&client->shmem);
+        svcCloseHandle(client->wake);
+        return rc;
+    }
+    
+    client->ring = (NotifRing*)shmemGetAddr(&client->shmem);
+    if (!notif_ring_valid(client->ring)) {
+        _notif_ring_unmap(client);
+        return -7;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief 写入已映射的环，环已关闭或已满时解除映射（调用者持有 client->mutex）
+ * @param client 客户端状态
+ * @param request 请求体
+ * @return NotifRingPushResult 写入结果
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline NotifRingPushResult _notif_ring_push_locked(_NotifRingClient* client, const NotifPostRequest* request) {
+    // 映射后内存被改写（不是本协议的环）时不再写入
+    if (!notif_ring_valid(client->ring)) {
+        _notif_ring_unmap(client);
+        return NOTIF_RING_CLOSED;
+    }
+    
+    bool wake = false;
+    NotifRingPushResult res = notif_ring_push(client->ring, request, &wake);
+    
+    // 已关闭：系统模块已退出（或即将退出）；已满：系统模块可能已异常退出，没有消费者
+    // 两种情况都解除映射，由调用者重新获取
+    if (res != NOTIF_RING_PUSHED) {
+        _notif_ring_unmap(client);
+        return res;
+    }
+    
+    // 只在环从空变为非空时唤醒系统模块
+    if (wake) svcSignalEvent(client->wake);
+    return NOTIF_RING_PUSHED;
+}
+
+/**
+ * @brief 写入共享内存环投递通知（无 IPC 往返，适合高频调用）
+ * @param request 请求体
+ * @return Result 0=成功，失败时应回退到 IPC 或文件投递
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline Result _notif_ring_post(const NotifPostRequest* request) {
+    _NotifRingClient* client = &_notif_ring_client;
+    NotifRingPushResult res;
+    Result rc = 0;
+    
+    mutexLock(&client->mutex);
+    
+    // 首次使用或上次解除映射后重新映射
+    if (!client->ring) {
+        rc = _notif_ring_map(client);
+        if (R_FAILED(rc)) goto cleanup;
+    }
+    
+    res = _notif_ring_push_locked(client, request);
+    
+    // 映射的环已失效：重新映射一次，系统模块仍在运行时会拿到当前的环
+    if (res != NOTIF_RING_PUSHED) {
+        rc = _notif_ring_map(client);
+        if (R_FAILED(rc)) goto cleanup;
+        res = _notif_ring_push_locked(client, request);
+    }
+    
+    if (res == NOTIF_RING_CLOSED) rc = -7;
+    else if (res == NOTIF_RING_FULL) rc = -8;
+
+cleanup:
+    mutexUnlock(&client->mutex);
+    return rc;
+}
+
+/**
+ * @brief 本库的全局锁（整个程序共用一份，同步调用和异步工作线程共用，保护缓存和文件计数）
+ * @warning 这是内部变量，用户不应直接使用
+ */
+_NOTIF_SHARED Mutex _notif_mutex;
+
+/**
+ * @brief 发送通知（不加锁）
+ * @warning 这是内部函数，用户不应直接调用，请使用 createNotification
+ */
+static inline Result _notif_create(const char* text, 
+                                   int duration,
+                                   NotificationType type, 
+                                   NotificationPosition position) {
 
     // 检查系统模块文件
     if (!_notif_check_module_file()) return -5;
@@ -245,22 +896,40 @@ static inline Result createNotification(const char* text,
         if (*p == '\n' || *p == '\r') *p = ' ';
     }
 
-    // 转换枚举为字符串
-    const char* type_str = (type == INFO) ? "INFO" : "ERROR";
-    const char* pos_str = (position == LEFT) ? "LEFT" : 
-                          (position == MIDDLE) ? "MIDDLE" : "RIGHT";
+    // 系统模块正在运行时优先写入共享内存环，其次通过 IPC 投递（不写 SD 卡，立即显示）
+    NotifPostRequest request;
+    memset(&request, 0, sizeof(request));
+    memcpy(request.text, clean_text, sizeof(request.text));
+    request.type = (u32)type;
+    request.position = (u32)position;
+    request.duration = (u32)duration;
+    
+    if (R_SUCCEEDED(_notif_ring_post(&request))) return 0;
+    if (R_SUCCEEDED(_notif_ipc_post(&request))) return 0;
+
+    // 日志模式：追加到投递日志，之后启动系统模块
+    // 追加失败（日志正被系统模块轮转等）时改用下面的通知文件，不丢弃通知
+    if (_notif_spool_enabled && R_SUCCEEDED(_notif_spool_post(&request))) {
+        return _notif_ensure_running();
+    }
+
+    // 否则通过文件投递（冷启动路径），之后启动系统模块
+
+    // 编码为二进制通知记录
+    u8 record[NOTIF_RECORD_MAX_SIZE];
+    size_t record_size = notifEncodeRecord(record, sizeof(record), clean_text, strlen(clean_text), type, position, duration);
+    if (record_size == 0) return -3;
     
-    // 生成随机临时文件路径
+    // 生成带投递序号的临时文件路径
     char temp_path[256];
-    _notif_random_path(temp_path, sizeof(temp_path));
+    _notif_sequenced_path(temp_path, sizeof(temp_path));
     
     // 写入临时文件
-    FILE* f = fopen(temp_path, "w");
+    FILE* f = fopen(temp_path, "wb");
     if (!f) return -3;
     
     // 写入文件内容失败，删除临时文件
-    if (fprintf(f, "text=%s\ntype=%s\nposition=%s\nduration=%d\n", 
-                clean_text, type_str, pos_str, duration) < 0) {
+    if (fwrite(record, 1, record_size, f) != record_size) {
         fclose(f);
         remove(temp_path);
         return -3;
@@ -294,6 +963,210 @@ static inline Result createNotification(const char* text,
     return 0;
 }
 
+/**
+ * @brief 发送通知
+ * @param text 通知文本
+ * @param duration 显示时长（秒，范围 1-10）
+ * @param type 通知类型 (INFO / ERROR)
+ * @param position 通知位置 (LEFT / MIDDLE / RIGHT)
+ * @return Result 0=成功，负数=失败
+ * @note 在调用线程上同步完成，系统模块未运行时可能等待 SD 卡数毫秒；
+ *       不能等待的线程（如输入处理循环）请使用 createNotificationAsync
+ */
+static inline Result createNotification(const char* text, 
+                                        int duration,
+                                        NotificationType type, 
+                                        NotificationPosition position) {
+    mutexLock(&_notif_mutex);
+    Result rc = _notif_create(text, duration, type, position);
+    mutexUnlock(&_notif_mutex);
+    return rc;
+}
+
+// 异步投递配置
+#define NOTIF_ASYNC_QUEUE_SIZE  8        // 等待投递的通知数
+#define NOTIF_ASYNC_STACK_SIZE  0x4000   // 工作线程栈大小
+
+/**
+ * @brief 异步投递完成回调（在工作线程中调用，应尽快返回）
+ * @param rc createNotification 的结果
+ * @param user 投递时传入的调用者数据
+ * @warning 回调中不能调用 notifAsyncFlush（工作线程会等待自己退出而死锁）
+ */
+typedef void (*NotifCompletionCallback)(Result rc, void* user);
+
+/**
+ * @brief 异步投递状态（配合 notifAsyncStatusCallback 使用，投递完成前须保持有效）
+ */
+typedef struct {
+    u32 done;     // 投递完成后为 1
+    Result rc;    // 投递结果（done 为 1 后有效）
+} NotifAsyncStatus;
+
+/**
+ * @brief 异步投递队列中的一条通知
+ * @warning 这是内部结构，用户不应直接使用
+ */
+typedef struct {
+    char text[32];
+    int duration;
+    NotificationType type;
+    NotificationPosition position;
+    NotifCompletionCallback callback;
+    void* user;
+} _NotifAsyncItem;
+
+/**
+ * @brief 异步投递队列和工作线程
+ * @warning 这是内部结构，用户不应直接使用
+ */
+typedef struct {
+    Mutex mutex;
+    CondVar work;          // 有新通知或要求退出
+    Thread thread;         // 工作线程（首次异步投递时创建）
+    bool running;          // 工作线程已创建
+    bool stopping;         // notifAsyncFlush 进行中，不再接受新通知
+    u32 head;              // 队首下标
+    u32 count;             // 队列中的通知数
+    _NotifAsyncItem items[NOTIF_ASYNC_QUEUE_SIZE];
+} _NotifAsync;
+
+/**
+ * @brief 异步投递队列（整个程序共用一份，所有源文件共用一个工作线程）
+ * @warning 这是内部变量，用户不应直接使用
+ */
+_NOTIF_SHARED _NotifAsync _notif_async_queue;
+
+/**
+ * @brief 工作线程：逐条取出通知同步投递，要求退出时投递完队列中剩余的通知再退出
+ * @warning 这是内部函数，用户不应直接调用
+ */
+static inline void _notif_async_worker(void* arg) {
+    _NotifAsync* q = (_NotifAsync*)arg;
+    
+    mutexLock(&q->mutex);
+    while (true) {
+        while (q->count == 0 && !q->stopping) condvarWait(&q->work, &q->mutex);
+        if (q->count == 0) break;
+        
+        _NotifAsyncItem item = q->items[q->head];
+        q->head = (q->head + 1) % NOTIF_ASYNC_QUEUE_SIZE;
+        q->count--;
+        
+        // 投递时不持有队列锁，调用者可以继续入队
+        mutexUnlock(&q->mutex);
+        Result rc = createNotification(item.text, item.duration, item.type, item.position);
+        if (item.callback) item.callback(rc, item.user);
+        mutexLock(&q->mutex);
+    }
+    mutexUnlock(&q->mutex);
+}
+
+/**
+ * @brief 异步发送通知（只入队，立即返回，由工作线程完成文件写入和系统模块启动）
+ * @param text 通知文本（入队时拷贝，调用返回后即可释放）
+ * @param duration 显示时长（秒，范围 1-10）
+ * @param type 通知类型 (INFO / ERROR)
+ * @param position 通知位置 (LEFT / MIDDLE / RIGHT)
+ * @param callback 完成回调（可为 NULL），在工作线程中调用
+ * @param user 传给回调的调用者数据
+ * @return Result 0=已入队，-1=参数无效，-9=队列已满，-10=正在 flush，其他=工作线程创建失败
+ * @note 首次调用时创建工作线程（优先级与调用线程相同），退出前须调用 notifAsyncFlush
+ */
+static inline Result createNotificationAsync(const char* text,
+                                             int duration,
+                                             NotificationType type,
+                                             NotificationPosition position,
+                                             NotifCompletionCallback callback,
+                                             void* user) {
+    if (!text || text[0] == '\0') return -1;
+    
+    _NotifAsync* q = &_notif_async_queue;
+    Result rc = 0;
+    
+    mutexLock(&q->mutex);
+    if (q->stopping) {
+        rc = -10;
+    } else if (q->count == NOTIF_ASYNC_QUEUE_SIZE) {
+        rc = -9;
+    } else if (!q->running) {
+        // 首次使用时创建工作线程
+        s32 prio = 0x2C;
+        svcGetThreadPriority(&prio, CUR_THREAD_HANDLE);
+        rc = threadCreate(&q->thread, _notif_async_worker, q, NULL, NOTIF_ASYNC_STACK_SIZE, prio, -2);
+        if (R_SUCCEEDED(rc)) {
+            rc = threadStart(&q->thread);
+            if (R_FAILED(rc)) threadClose(&q->thread);
+        }
+        if (R_SUCCEEDED(rc)) q->running = true;
+    }
+    
+    if (R_SUCCEEDED(rc)) {
+        _NotifAsyncItem* item = &q->items[(q->head + q->count) % NOTIF_ASYNC_QUEUE_SIZE];
+        strncpy(item->text, text, sizeof(item->text) - 1);
+        item->text[sizeof(item->text) - 1] = '\0';
+        item->duration = duration;
+        item->type = type;
+        item->position = position;
+        item->callback = callback;
+        item->user = user;
+        q->count++;
+        condvarWakeOne(&q->work);
+    }
+    mutexUnlock(&q->mutex);
+    
+    return rc;
+}
+
+/**
+ * @brief 等待已入队的异步通知全部投递完成并结束工作线程（退出程序、关闭服务前调用）
+ * @note 会阻塞到队列清空；之后再次异步投递会重新创建工作线程。
+ *       只应由一个线程调用，flush 期间的异步投递返回 -10
+ * @warning 不能在完成回调中调用：回调运行在工作线程上，等待工作线程退出会永远阻塞
+ */
+static inline void notifAsyncFlush(void) {
+    _NotifAsync* q = &_notif_async_queue;
+    
+    mutexLock(&q->mutex);
+    if (!q->running || q->stopping) {
+        mutexUnlock(&q->mutex);
+        return;
+    }
+    q->stopping = true;
+    condvarWakeOne(&q->work);
+    mutexUnlock(&q->mutex);
+    
+    threadWaitForExit(&q->thread);
+    threadClose(&q->thread);
+    
+    mutexLock(&q->mutex);
+    q->running = false;
+    q->stopping = false;
+    mutexUnlock(&q->mutex);
+}
+
+/**
+ * @brief 完成回调：把结果写入 NotifAsyncStatus（user 传状态指针）
+ * @param rc 投递结果
+ * @param user NotifAsyncStatus 指针
+ */
+static inline void notifAsyncStatusCallback(Result rc, void* user) {
+    NotifAsyncStatus* status = (NotifAsyncStatus*)user;
+    status->rc = rc;
+    __atomic_store_n(&status->done, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 检查异步投递是否完成
+ * @param status 投递时传入的状态（须先清零）
+ * @return true 已完成（结果在 status->rc）, false 仍在队列中或正在投递
+ */
+static inline bool notifAsyncStatusDone(const NotifAsyncStatus* status) {
+    return __atomic_load_n(&status->done, __ATOMIC_ACQUIRE) != 0;
+}
+
+#endif // LIBNOTIFICATION_PROTOCOL_ONLY
+
 #ifdef __cplusplus
 }
 #endif
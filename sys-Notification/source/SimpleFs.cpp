@@ -1,12 +1,43 @@
 #include "SimpleFs.hpp"
 #include <dirent.h>
+#include <sys/stat.h>
 #include <cerrno>
 #include <cstdio>
+#include <cstring>
 
 // 定义静态成员
 char SimpleFs::s_PathBuffer[256];     // 路径缓冲区
 char SimpleFs::s_ContentBuffer[256];  // 文件内容缓冲区
 
+bool SimpleFs::HasExtension(const char* name, const char* ext) {
+    size_t len = 0;
+    while (name[len] != '\0') len++;
+    
+    size_t ext_len = 0;
+    while (ext[ext_len] != '\0') ext_len++;
+    
+    if (len <= ext_len + 1 || name[len - ext_len - 1] != '.') return false;
+    
+    // 只比较 ASCII 字母，大小写不敏感
+    for (size_t i = 0; i < ext_len; i++) {
+        char c = name[len - ext_len + i];
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        if (c != ext[i]) return false;
+    }
+    return true;
+}
+
+bool SimpleFs::IsIniFile(const char* name) {
+    return HasExtension(name, "ini");
+}
+
+bool SimpleFs::IsRecordFile(const char* name) {
+    return HasExtension(name, "ntf");
+}
+
+// 以下为 POSIX 后端（主机构建），Switch 上的原生后端见 SimpleFsNative.cpp
+#if !SIMPLEFS_NATIVE
+
 bool SimpleFs::DirectoryExists(const char* dir_path) {
     if (!dir_path || dir_path[0] == '\0') {
         return false;
@@ -100,14 +131,7 @@ const char* SimpleFs::GetFirstIniFile(const char* dir_path) {
         
         // 检查是否以 .ini 结尾
         const char* name = entry->d_name;
-        size_t len = 0;
-        while (name[len] != '\0') len++;
-        
-        if (len > 4 && 
-            name[len-4] == '.' &&
-            (name[len-3] == 'i' || name[len-3] == 'I') &&
-            (name[len-2] == 'n' || name[len-2] == 'N') &&
-            (name[len-1] == 'i' || name[len-1] == 'I')) {
+        if (IsIniFile(name)) {
             
             // 这句话忽略编译器警告
             #pragma GCC diagnostic push
@@ -124,6 +148,53 @@ const char* SimpleFs::GetFirstIniFile(const char* dir_path) {
     return nullptr;  // 没找到
 }
 
+bool SimpleFs::ScanNotificationFiles(const char* dir_path, NotificationFileCallback callback, void* user, bool* has_temp) {
+    if (has_temp) *has_temp = false;
+    
+    if (!dir_path || dir_path[0] == '\0' || !callback) {
+        return false;
+    }
+    
+    DIR* dir = opendir(dir_path);
+    if (!dir) {
+        return false;
+    }
+    
+    struct dirent* entry;
+    
+    while ((entry = readdir(dir)) != nullptr) {
+        // 只处理普通文件
+        if (entry->d_type != DT_REG) {
+            continue;
+        }
+        
+        // 记录写入中的临时文件（重命名为 .ini / .ntf 之前）
+        if (!IsIniFile(entry->d_name) && !IsRecordFile(entry->d_name)) {
+            size_t len = strlen(entry->d_name);
+            if (has_temp && len > 5 && strcmp(entry->d_name + len - 5, ".temp") == 0) *has_temp = true;
+            continue;
+        }
+        
+        callback(entry->d_name, user);
+    }
+    
+    closedir(dir);
+    return true;
+}
+
+uint64_t SimpleFs::GetModifiedTime(const char* file_path) {
+    if (!file_path || file_path[0] == '\0') {
+        return 0;
+    }
+    
+    struct stat st;
+    if (stat(file_path, &st) != 0) {
+        return 0;
+    }
+    
+    return (uint64_t)st.st_mtime;
+}
+
 bool SimpleFs::DeleteFile(const char* file_path) {
     if (!file_path || file_path[0] == '\0') {
         return false;
@@ -132,7 +203,7 @@ bool SimpleFs::DeleteFile(const char* file_path) {
     return remove(file_path) == 0;
 }
 
-const char* SimpleFs::ReadFileContent(const char* file_path) {
+const char* SimpleFs::ReadFileContent(const char* file_path, size_t* out_size) {
     if (!file_path || file_path[0] == '\0') {
         return nullptr;
     }
@@ -162,6 +233,8 @@ const char* SimpleFs::ReadFileContent(const char* file_path) {
         return nullptr;
     }
     
+    if (out_size) *out_size = read_size;
     return s_ContentBuffer;  // 返回内容缓冲区指针
 }
 
+#endif // !SIMPLEFS_NATIVE
@@ -1,7 +1,26 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
+// 文件系统后端：Switch 上直接调用 SD 卡 FsFileSystem（批量读取目录项），主机构建使用 POSIX
+#ifndef SIMPLEFS_NATIVE
+#ifdef __SWITCH__
+#define SIMPLEFS_NATIVE 1
+#else
+#define SIMPLEFS_NATIVE 0
+#endif
+#endif
+
 class SimpleFs {
 public:
+    /**
+     * @brief 扫描目录时每个通知文件（.ini / .ntf）的回调
+     * @param name 文件名（不含目录）
+     * @param user 调用者数据
+     */
+    typedef void (*NotificationFileCallback)(const char* name, void* user);
+    
     /**
      * @brief 检查目录是否存在
      * @param dir_path 目录路径
@@ -31,6 +50,23 @@ public:
      */
     static const char* GetFirstIniFile(const char* dir_path);
     
+    /**
+     * @brief 一次遍历目录下所有通知文件（.ini 和二进制记录 .ntf）
+     * @param dir_path 目录路径
+     * @param callback 每个文件调用一次
+     * @param user 传给回调的调用者数据
+     * @param has_temp 输出：目录中是否有写入中的 .temp 文件（可为 nullptr）
+     * @return true 成功, false 目录无法打开
+     */
+    static bool ScanNotificationFiles(const char* dir_path, NotificationFileCallback callback, void* user, bool* has_temp = nullptr);
+    
+    /**
+     * @brief 获取文件修改时间
+     * @param file_path 文件路径
+     * @return 修改时间，失败返回 0
+     */
+    static uint64_t GetModifiedTime(const char* file_path);
+    
     /**
      * @brief 删除单个文件
      * @param file_path 文件路径
@@ -41,12 +77,28 @@ public:
     /**
      * @brief 读取文件全部内容到内存
      * @param file_path 文件路径
-     * @return 文件内容指针，失败返回 nullptr
+     * @param out_size 输出：内容字节数（可为 nullptr，二进制文件需要）
+     * @return 文件内容指针（末尾附加 '\0'），失败返回 nullptr
      * @note 返回的指针指向内部静态缓冲区，下次调用会覆盖
      */
-    static const char* ReadFileContent(const char* file_path);
+    static const char* ReadFileContent(const char* file_path, size_t* out_size = nullptr);
+    
+    /**
+     * @brief 检查文件名是否为二进制通知记录（以 .ntf 结尾，不区分大小写）
+     */
+    static bool IsRecordFile(const char* name);
     
 private:
+    /**
+     * @brief 检查文件名是否以 .ini 结尾（不区分大小写）
+     */
+    static bool IsIniFile(const char* name);
+    
+    /**
+     * @brief 检查文件名是否以 ext（如 "ini"）结尾，不区分大小写
+     */
+    static bool HasExtension(const char* name, const char* ext);
+    
     static char s_PathBuffer[256];     // 路径缓冲区
     static char s_ContentBuffer[256];  // 文件内容缓冲区
 };
@@ -0,0 +1,229 @@
+#include "SimpleFs.hpp"
+
+// Switch 原生后端：直接调用 SD 卡 FsFileSystem，绕过 fsdev/newlib
+#if SIMPLEFS_NATIVE
+
+#include <switch.h>
+#include <cstdio>
+#include <cstring>
+
+#define DIR_READ_BATCH 8  // 每次 fsDirRead 读取的目录项数
+
+static const Result FsResultPathAlreadyExists = MAKERESULT(Module_Fs, 2);
+
+static FsDirectoryEntry s_DirEntries[DIR_READ_BATCH];    // 目录项批量读取缓冲区
+
+// 获取 SD 卡文件系统（由 fsdevMountSdmc 挂载）
+static FsFileSystem* GetSdmc() {
+    return fsdevGetDeviceFileSystem("sdmc");
+}
+
+// 去掉 "sdmc:" 前缀，原生接口只接受设备内的绝对路径
+static const char* StripDevice(const char* path) {
+    if (strncmp(path, "sdmc:", 5) == 0) return path + 5;
+    return path;
+}
+
+// 批量遍历目录下的文件，每个文件调用一次 fn，fn 返回 false 时停止遍历
+// 返回 false 表示目录无法打开或读取失败
+template <typename Fn>
+static bool ForEachFile(FsFileSystem* fs, const char* dir_path, Fn fn) {
+    FsDir dir;
+    if (R_FAILED(fsFsOpenDirectory(fs, dir_path, FsDirOpenMode_ReadFiles | FsDirOpenMode_NoFileSize, &dir))) {
+        return false;
+    }
+    
+    bool success = true;
+    bool done = false;
+    while (!done) {
+        s64 total = 0;
+        if (R_FAILED(fsDirRead(&dir, &total, DIR_READ_BATCH, s_DirEntries))) {
+            success = false;
+            break;
+        }
+        if (total <= 0) break;
+        
+        for (s64 i = 0; i < total; i++) {
+            if (!fn(s_DirEntries[i].name)) {
+                done = true;
+                break;
+            }
+        }
+    }
+    
+    fsDirClose(&dir);
+    return success;
+}
+
+bool SimpleFs::DirectoryExists(const char* dir_path) {
+    if (!dir_path || dir_path[0] == '\0') {
+        return false;
+    }
+    
+    FsFileSystem* fs = GetSdmc();
+    if (!fs) return false;
+    
+    FsDirEntryType type;
+    if (R_FAILED(fsFsGetEntryType(fs, StripDevice(dir_path), &type))) {
+        return false;
+    }
+    
+    return type == FsDirEntryType_Dir;
+}
+
+bool SimpleFs::CreateDirectory(const char* dir_path) {
+    if (!dir_path || dir_path[0] == '\0') {
+        return false;
+    }
+    
+    // 如果目录已存在，返回成功
+    if (DirectoryExists(dir_path)) {
+        return true;
+    }
+    
+    FsFileSystem* fs = GetSdmc();
+    if (!fs) return false;
+    
+    Result rc = fsFsCreateDirectory(fs, StripDevice(dir_path));
+    
+    // 如果错误是"已存在"，也算成功（处理竞态条件）
+    return R_SUCCEEDED(rc) || R_VALUE(rc) == FsResultPathAlreadyExists;
+}
+
+bool SimpleFs::ClearDirectory(const char* dir_path) {
+    if (!dir_path || dir_path[0] == '\0') {
+        return false;
+    }
+    
+    FsFileSystem* fs = GetSdmc();
+    if (!fs) return false;
+    
+    const char* dir = StripDevice(dir_path);
+    bool success = true;
+    
+    // 只删除普通文件，不删除子目录（目录以 ReadFiles 模式打开）
+    bool opened = ForEachFile(fs, dir, [&](const char* name) {
+        char file_path[FS_MAX_PATH];
+        snprintf(file_path, sizeof(file_path), "%s/%s", dir, name);
+        
+        if (R_FAILED(fsFsDeleteFile(fs, file_path))) {
+            success = false;
+        }
+        return true;
+    });
+    
+    return opened && success;
+}
+
+const char* SimpleFs::GetFirstIniFile(const char* dir_path) {
+    if (!dir_path || dir_path[0] == '\0') {
+        return nullptr;
+    }
+    
+    FsFileSystem* fs = GetSdmc();
+    if (!fs) return nullptr;
+    
+    bool found = false;
+    ForEachFile(fs, StripDevice(dir_path), [&](const char* name) {
+        if (!IsIniFile(name)) return true;
+        
+        // 这句话忽略编译器警告
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wformat-truncation"
+        // 拼接到路径缓冲区
+        snprintf(s_PathBuffer, sizeof(s_PathBuffer), "%s/%s", dir_path, name);
+        #pragma GCC diagnostic pop
+        found = true;
+        return false;
+    });
+    
+    return found ? s_PathBuffer : nullptr;
+}
+
+bool SimpleFs::ScanNotificationFiles(const char* dir_path, NotificationFileCallback callback, void* user, bool* has_temp) {
+    if (has_temp) *has_temp = false;
+    
+    if (!dir_path || dir_path[0] == '\0' || !callback) {
+        return false;
+    }
+    
+    FsFileSystem* fs = GetSdmc();
+    if (!fs) return false;
+    
+    return ForEachFile(fs, StripDevice(dir_path), [&](const char* name) {
+        // 记录写入中的临时文件（重命名为 .ini / .ntf 之前）
+        if (!IsIniFile(name) && !IsRecordFile(name)) {
+            size_t len = strlen(name);
+            if (has_temp && len > 5 && strcmp(name + len - 5, ".temp") == 0) *has_temp = true;
+            return true;
+        }
+        
+        callback(name, user);
+        return true;
+    });
+}
+
+uint64_t SimpleFs::GetModifiedTime(const char* file_path) {
+    if (!file_path || file_path[0] == '\0') {
+        return 0;
+    }
+    
+    FsFileSystem* fs = GetSdmc();
+    if (!fs) return 0;
+    
+    FsTimeStampRaw ts;
+    if (R_FAILED(fsFsGetFileTimeStampRaw(fs, StripDevice(file_path), &ts)) || !ts.is_valid) {
+        return 0;
+    }
+    
+    return ts.modified;
+}
+
+bool SimpleFs::DeleteFile(const char* file_path) {
+    if (!file_path || file_path[0] == '\0') {
+        return false;
+    }
+    
+    FsFileSystem* fs = GetSdmc();
+    if (!fs) return false;
+    
+    return R_SUCCEEDED(fsFsDeleteFile(fs, StripDevice(file_path)));
+}
+
+const char* SimpleFs::ReadFileContent(const char* file_path, size_t* out_size) {
+    if (!file_path || file_path[0] == '\0') {
+        return nullptr;
+    }
+    
+    FsFileSystem* fs = GetSdmc();
+    if (!fs) return nullptr;
+    
+    FsFile file;
+    if (R_FAILED(fsFsOpenFile(fs, StripDevice(file_path), FsOpenMode_Read, &file))) {
+        return nullptr;
+    }
+    
+    const char* content = nullptr;
+    s64 file_size = 0;
+    u64 read_size = 0;
+    
+    // 获取文件大小
+    if (R_FAILED(fsFileGetSize(&file, &file_size))) goto cleanup;
+    
+    // 检查大小（文件太大或为空）
+    if (file_size <= 0 || file_size >= (s64)sizeof(s_ContentBuffer)) goto cleanup;
+    
+    // 一次读取到内容缓冲区
+    if (R_FAILED(fsFileRead(&file, 0, s_ContentBuffer, file_size, FsReadOption_None, &read_size))) goto cleanup;
+    if (read_size != (u64)file_size) goto cleanup;
+    
+    s_ContentBuffer[read_size] = '\0';  // 添加 null terminator
+    if (out_size) *out_size = read_size;
+    content = s_ContentBuffer;  // 返回内容缓冲区指针
+    
+cleanup:
+    fsFileClose(&file);
+    return content;
+}
+
+#endif // SIMPLEFS_NATIVE
@@ -1,24 +1,61 @@
 #include "app.hpp"
 #include <cstring>
 #include "SimpleFs.hpp"
+#include "font_manager.hpp"
+#include "util/log.h"
 
 
 #define NOTIFICATION_PATH "/config/sys-Notification"
+#define CACHE_PATH        NOTIFICATION_PATH "/cache"
+#define GLYPH_CACHE_FILE  CACHE_PATH "/glyphs.bin"
+#define SPOOL_FILE        NOTIFICATION_PATH "/spool.bin"
 
-App::App() {
+App::App() : m_DirWatch(NOTIFICATION_PATH), m_Spool(SPOOL_FILE), m_Dispatcher(*this), m_RingTransport(m_Dispatcher), m_IpcTransport(m_Dispatcher), m_RequestHead(0), m_RequestCount(0) {
 
+    // 新任务事件（自动清除）
+    ueventCreate(&m_WorkEvent, true);
+    mutexInit(&m_RequestMutex);
+    
     // 检查并创建通知目录
     if (!SimpleFs::DirectoryExists(NOTIFICATION_PATH)) {
         SimpleFs::CreateDirectory(NOTIFICATION_PATH);
     }
+    
+    // 检查并创建缓存目录
+    if (!SimpleFs::DirectoryExists(CACHE_PATH)) {
+        SimpleFs::CreateDirectory(CACHE_PATH);
+    }
 
     // 初始化通知管理器
     Result rc = m_NotifMgr.Init();
     if (R_FAILED(rc)) fatalThrow(rc);  // 初始化失败，抛出致命错误
+    
+    // 加载上次保存的字形缓存（首帧即可命中）
+    // 在帧缓冲、nv 传输内存和线性表面分配之后再加载，小块缓存不把堆切碎
+    FontManager::Instance().LoadGlyphCache(GLYPH_CACHE_FILE);
+    
+    // 已渲染面板持久化到缓存目录，重复通知冷启动也能命中
+    m_NotifMgr.SetCacheDirectory(CACHE_PATH);
+    
+    // 创建共享内存环（失败时客户端改用 IPC 投递）
+    rc = m_RingTransport.Start();
+    if (R_FAILED(rc)) log_warning("notif ring create failed: 0x%x", rc);
+    
+    // 启动 IPC 服务（失败时仍可通过文件投递）
+    m_IpcTransport.SetRing(&m_RingTransport);
+    rc = m_IpcTransport.Start();
+    if (R_FAILED(rc)) log_warning("notif service start failed: 0x%x", rc);
         
 }
 
 App::~App() {
+    m_IpcTransport.Stop();
+    m_RingTransport.Stop();
+    
+    // 退出前写回新光栅化的字形，下次冷启动直接使用
+    FontManager::Instance().SaveGlyphCache(GLYPH_CACHE_FILE);
+    
+    log_info("panel cache: %u hits, %u misses", m_NotifMgr.GetPanelCacheHits(), m_NotifMgr.GetPanelCacheMisses());
 }
 
 void App::Loop() {
@@ -30,91 +67,204 @@ void App::Loop() {
     u64 last_activity_time = armGetSystemTick();  // 最后一次活动时间
     u64 show_start_time = 0;                      // 当前通知开始显示的时间
     u64 hide_time = 0;                            // 应该隐藏的时间点
+    u64 next_scan_time = last_activity_time;      // 下一次扫描目录的时间点
     
     const u64 timeout_ns = 1000000000ULL;         // 1 秒超时（纳秒）
     const u64 min_display_ns = 1000000000ULL;     // 最小显示时长 1 秒（纳秒）
-    const u64 sleep_ns = 200000000ULL;            // 每次循环休眠 200ms
+    const u64 scan_ns = 200000000ULL;             // SD 卡没有变更通知，目录仍每 200ms 扫描一次
     
     while (true) {
         // 获取当前时间
         u64 now = armGetSystemTick();
         
-        // 扫描第一个 INI 文件
-        const char* file = SimpleFs::GetFirstIniFile(NOTIFICATION_PATH);
+        // 取出共享内存环中的记录放入请求队列
+        m_RingTransport.Drain();
+        
+        // 当前通知到期，准时隐藏
+        if (state == SHOWING && now >= hide_time) {
+            m_NotifMgr.Hide();
+            state = IDLE;
+            last_activity_time = now;  // 更新超时计时起点（从Hide后开始计时）
+        }
         
-        // 如果有文件
-        if (file) {
-            // 重置超时计时器
-            last_activity_time = now;  
+        // 到达扫描时间点（或被新任务事件提前唤醒）才扫描目录
+        if (now >= next_scan_time) {
+            next_scan_time = now + armNsToTicks(scan_ns);
             
-            // 如果有旧的通知正在显示，检查是否满 1 秒
-            if (state == SHOWING) {
-                u64 elapsed_ns = armTicksToNs(now - show_start_time);
-                if (elapsed_ns < min_display_ns) {
-                    // 未满 1 秒，等待
-                    svcSleepThread(sleep_ns);
-                    continue;
-                }
-                // 满 1 秒，删除旧的通知
-                m_NotifMgr.Hide();
-                state = IDLE;
+            // IPC / 共享内存环的请求优先，其次是投递日志，没有时再取待处理队列中最旧的 INI 文件
+            // 队列为空且目录有变化时才扫描目录（一次收集全部文件）
+            bool has_request = HasPendingRequests();
+            if (!has_request) {
+                // 日志记录放入请求队列，留一半空位给 IPC 服务线程
+                // 队列被服务线程填满时只确认已放入的记录，其余留在日志中下次再读
+                NotifPostRequest records[REQUEST_QUEUE_SIZE / 2];
+                int count = m_Spool.Peek(records, REQUEST_QUEUE_SIZE / 2);
+                int accepted = 0;
+                while (accepted < count && R_SUCCEEDED(Post(records[accepted]))) accepted++;
+                m_Spool.Consume(accepted);
+                has_request = accepted > 0;
             }
-            
-            // 读取并解析文件
-            const char* content = SimpleFs::ReadFileContent(file);
-            // 解析出来通知所需的结构体
-            NotificationConfig config = ParseIni(content);
-            
-            // 立即删除文件
-            SimpleFs::DeleteFile(file);
-            
-            // 检查解析出来的通知配置项，无效则跳过
-            if (config.text[0] == '\0') {
-                svcSleepThread(sleep_ns);
-                continue;
+            if (!has_request && m_Pending.Empty() && m_DirWatch.HasChanged()) {
+                m_Pending.Scan(NOTIFICATION_PATH);
+                m_DirWatch.Commit();
+                if (m_Pending.NeedsRescan()) m_DirWatch.ForceRescan();
             }
+            const char* file = has_request ? nullptr : m_Pending.Front();
             
-            // 显示新通知
-            m_NotifMgr.Show(config.text, config.position, config.type);
-            // 记录通知开始显示的时间
-            show_start_time = now;
-            
-            // 检查是否还有其他文件（判断显示时长）（如果有，则显示时长为1秒，没有就按配置项中的时长）
-            const char* next_file = SimpleFs::GetFirstIniFile(NOTIFICATION_PATH);
-            u64 display_duration = next_file ? min_display_ns : config.duration;
-            
-            // 计算删除这个通知的时间点
-            hide_time = show_start_time + armNsToTicks(display_duration);
-            state = SHOWING;
-            
-            svcSleepThread(sleep_ns);
-            continue;
-        }
-        
-        // 没有新文件，检查当前通知是否到期
-        if (state == SHOWING) {
-            if (now >= hide_time) {
-                m_NotifMgr.Hide();
-                state = IDLE;
-                last_activity_time = now;  // 更新超时计时起点（从Hide后开始计时）
+            if (has_request || file) {
+                // 重置超时计时器
+                last_activity_time = now;
+                
+                u64 min_display_end = show_start_time + armNsToTicks(min_display_ns);
+                if (state == SHOWING && now < min_display_end) {
+                    // 旧通知未满 1 秒，满 1 秒时再处理
+                    next_scan_time = min_display_end;
+                } else {
+                    // 满 1 秒，删除旧的通知
+                    if (state == SHOWING) {
+                        m_NotifMgr.Hide();
+                        state = IDLE;
+                    }
+                    
+                    NotificationConfig config;
+                    if (has_request) {
+                        PopRequest(&config);
+                    } else {
+                        // 读取并解析文件
+                        size_t size = 0;
+                        const char* content = SimpleFs::ReadFileContent(file, &size);
+                        // 解析出来通知所需的结构体（二进制记录原地读取，INI 逐行解析）
+                        config = SimpleFs::IsRecordFile(file) ? ParseRecord(content, size) : ParseIni(content);
+                        
+                        // 立即删除文件（自己删除的不算目录变化）
+                        if (SimpleFs::DeleteFile(file)) m_DirWatch.NoteRemoved();
+                        m_Pending.Pop();
+                    }
+                    
+                    // 检查解析出来的通知配置项，有效才显示
+                    if (config.text[0] != '\0') {
+                        // 显示新通知
+                        m_NotifMgr.Show(config.text, config.position, config.type);
+                        // 记录通知开始显示的时间
+                        show_start_time = now;
+                        
+                        // 检查是否还有其他请求或文件（判断显示时长）（如果有，则显示时长为1秒，没有就按配置项中的时长）
+                        bool has_next = HasPendingRequests() || m_Spool.HasPending() || !m_Pending.Empty();
+                        u64 display_duration = has_next ? min_display_ns : config.duration;
+                        
+                        // 计算删除这个通知的时间点
+                        hide_time = show_start_time + armNsToTicks(display_duration);
+                        state = SHOWING;
+                    }
+                }
             }
-            svcSleepThread(sleep_ns);
-            continue;
         }
         
         // 完全空闲，检查超时
-        u64 idle_ns = armTicksToNs(now - last_activity_time);
-        if (idle_ns > timeout_ns) {
-            break;  // 20 秒没活动，退出
+        if (state == IDLE && armTicksToNs(now - last_activity_time) > timeout_ns) {
+            // 先注销 IPC 服务并关闭环，之前已入队或写入环的请求仍要显示
+            m_IpcTransport.Stop();
+            m_RingTransport.Stop();
+            m_RingTransport.Drain();
+            // 注销期间回退到日志模式的客户端写入的记录也要显示
+            if (!HasPendingRequests() && !m_RingTransport.HasPending() && !m_Spool.Refresh()) break;  // 长时间没活动，退出
+            
+            // 重新开放后按正常节奏处理：日志末尾的半条记录在写完或过期前一直算作待处理，
+            // 不重置计时的话每一轮都会回到这里反复注销、重建服务
+            m_RingTransport.Start();
+            m_IpcTransport.Start();
+            last_activity_time = now;
+            next_scan_time = now;
         }
         
-        svcSleepThread(sleep_ns);
+        // 计算最近的截止时间：下一次扫描、通知到期、空闲超时
+        u64 deadline = next_scan_time;
+        if (state == SHOWING && hide_time < deadline) deadline = hide_time;
+        if (state == IDLE) {
+            u64 exit_time = last_activity_time + armNsToTicks(timeout_ns) + 1;
+            if (exit_time < deadline) deadline = exit_time;
+        }
+        
+        // 环中还有记录且请求队列有空位时不休眠，立即再取
+        if (!m_RingTransport.PrepareWait() && !IsRequestQueueFull()) continue;
+        
+        // 休眠到截止时间、新任务事件或环唤醒事件，不再空转
+        // 截止时间作为等待超时传入：UTimer 的间隔在创建时固定，每轮截止时间不同就得每轮重新创建
+        now = armGetSystemTick();
+        if (deadline > now) {
+            u64 timeout = armTicksToNs(deadline - now);
+            s32 idx = -1;
+            Result rc;
+            if (m_RingTransport.IsActive()) {
+                rc = waitMulti(&idx, timeout, waiterForUEvent(&m_WorkEvent), waiterForEvent(m_RingTransport.GetWakeEvent()));
+            } else {
+                rc = waitMulti(&idx, timeout, waiterForUEvent(&m_WorkEvent));
+            }
+            
+            // 新任务到达（没有超时），立即扫描
+            if (R_SUCCEEDED(rc)) next_scan_time = armGetSystemTick();
+        }
+        m_RingTransport.CancelWait();
     }
 }
 
 
 
 
+Result App::Post(const NotifPostRequest& request) {
+    mutexLock(&m_RequestMutex);
+    
+    if (m_RequestCount == REQUEST_QUEUE_SIZE) {
+        mutexUnlock(&m_RequestMutex);
+        return NOTIF_RESULT_QUEUE_FULL;
+    }
+    
+    // 转换为通知配置（取值校正与 INI 解析一致）
+    NotificationConfig& config = m_Requests[(m_RequestHead + m_RequestCount) % REQUEST_QUEUE_SIZE];
+    strncpy(config.text, request.text, sizeof(config.text) - 1);
+    config.text[sizeof(config.text) - 1] = '\0';
+    config.type = (request.type == ERROR) ? ERROR : INFO;
+    config.position = (request.position == LEFT) ? LEFT : (request.position == MIDDLE) ? MIDDLE : RIGHT;
+    
+    u32 seconds = request.duration;
+    if (seconds < 1) seconds = 2;
+    else if (seconds > 10) seconds = 10;
+    config.duration = (u64)seconds * 1000000000ULL;
+    
+    m_RequestCount++;
+    mutexUnlock(&m_RequestMutex);
+    
+    // 唤醒主循环
+    SignalWork();
+    return 0;
+}
+
+bool App::PopRequest(NotificationConfig* out) {
+    mutexLock(&m_RequestMutex);
+    bool ok = m_RequestCount > 0;
+    if (ok) {
+        *out = m_Requests[m_RequestHead];
+        m_RequestHead = (m_RequestHead + 1) % REQUEST_QUEUE_SIZE;
+        m_RequestCount--;
+    }
+    mutexUnlock(&m_RequestMutex);
+    return ok;
+}
+
+bool App::IsRequestQueueFull() {
+    mutexLock(&m_RequestMutex);
+    bool full = m_RequestCount == REQUEST_QUEUE_SIZE;
+    mutexUnlock(&m_RequestMutex);
+    return full;
+}
+
+bool App::HasPendingRequests() {
+    mutexLock(&m_RequestMutex);
+    bool pending = m_RequestCount > 0;
+    mutexUnlock(&m_RequestMutex);
+    return pending;
+}
+
 NotificationConfig App::ParseIni(const char* content) {
     
     NotificationConfig config;
@@ -205,5 +355,59 @@ NotificationConfig App::ParseIni(const char* content) {
     }
     
     
+    return config;
+}
+
+NotificationConfig App::ParseRecord(const char* content, size_t size) {
+    
+    // 默认值与 INI 解析一致
+    NotificationConfig config;
+    config.text[0] = '\0';
+    config.duration = 0;
+    config.type = INFO;
+    config.position = RIGHT;
+    
+    u32 length = content ? notif_record_length(content, size) : 0;
+    if (length == 0) {
+        log_warning("invalid notification record (%u bytes)", (u32)size);
+        return config;
+    }
+    
+    // 按字段类型取值，不认识的字段跳过
+    u32 offset = 0;
+    NotifRecordField field;
+    const void* value;
+    while ((value = notif_record_next_field(content, length, &offset, &field)) != nullptr) {
+        u32 number = 0;
+        if (field.size == sizeof(number)) memcpy(&number, value, sizeof(number));
+        
+        switch (field.id) {
+        case NOTIF_FIELD_TEXT: {
+            // 文本不一定以 '\0' 结尾，最多取 31 字节
+            u32 copy_len = 0;
+            const char* text = (const char*)value;
+            while (copy_len < field.size && copy_len < sizeof(config.text) - 1 && text[copy_len] != '\0') copy_len++;
+            memcpy(config.text, text, copy_len);
+            config.text[copy_len] = '\0';
+            break;
+        }
+        case NOTIF_FIELD_TYPE:
+            if (field.size == sizeof(number)) config.type = (number == ERROR) ? ERROR : INFO;
+            break;
+        case NOTIF_FIELD_POSITION:
+            if (field.size == sizeof(number)) config.position = (number == LEFT) ? LEFT : (number == MIDDLE) ? MIDDLE : RIGHT;
+            break;
+        case NOTIF_FIELD_DURATION:
+            if (field.size == sizeof(number)) {
+                if (number < 1) number = 2;
+                else if (number > 10) number = 10;
+                config.duration = (u64)number * 1000000000ULL;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    
     return config;
 }
@@ -2,6 +2,13 @@
 
 #include <switch.h>
 #include "notification.hpp"
+#include "notification_service.hpp"
+#include "pending_queue.hpp"
+#include "dir_watch.hpp"
+#include "spool_journal.hpp"
+
+// 请求队列长度（IPC 和共享内存环的请求在显示前暂存）
+#define REQUEST_QUEUE_SIZE 8
 
 // 通知配置结构体
 struct NotificationConfig {
@@ -11,18 +18,47 @@ struct NotificationConfig {
     u64 duration;                       // 持续时间 (纳秒)
 };
 
-class App {
+class App : public NotificationSink {
 public:
     App();
     ~App();
     
     void Loop();
+    
+    // 通知主循环有新任务（供非文件方式的通知来源唤醒主循环）
+    void SignalWork() { ueventSignal(&m_WorkEvent); }
+    
+    // 收到通知请求（IPC 服务线程或主循环取环时调用）：放入队列并唤醒主循环
+    Result Post(const NotifPostRequest& request) override;
 
 private:
     NotificationManager m_NotifMgr;
+    PendingQueue m_Pending;             // 待处理通知文件（按投递顺序）
+    DefaultDirChangeDetector m_DirWatch; // 通知目录变化检测（无变化时跳过扫描）
+    SpoolJournal m_Spool;               // 追加式投递日志（日志模式的客户端写入）
+    UEvent m_WorkEvent;                 // 新任务事件（自动清除）
+    
+    // 通知服务（环在 IPC 服务之前构造，IPC 服务线程先于环销毁）
+    NotificationDispatcher m_Dispatcher;
+    RingTransport m_RingTransport;      // 共享内存环
+    IpcTransport m_IpcTransport;        // IPC 服务 notif:u
     
-    // 解析 INI 内容
+    // 请求队列（IPC 服务线程和取环时写入，主循环读取）
+    Mutex m_RequestMutex;
+    NotificationConfig m_Requests[REQUEST_QUEUE_SIZE];
+    u32 m_RequestHead;
+    u32 m_RequestCount;
+    
+    // 取出最早的请求，队列为空返回 false
+    bool PopRequest(NotificationConfig* out);
+    bool HasPendingRequests();
+    bool IsRequestQueueFull();
+    
+    // 解析 INI 内容（旧版客户端）
     NotificationConfig ParseIni(const char* content);
+    
+    // 原地读取二进制通知记录（.ntf），格式无效时返回空文本
+    NotificationConfig ParseRecord(const char* content, size_t size);
 };
 
 
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// RGBA4444 定点混合：fg（带 alpha 的新颜色）叠加到 bg（已有像素）
+//   通道：(fg * a + bg * (15 - a)) / 15，截断取整
+//   alpha：fg.a + bg.a，限制到 15
+// 除以 15 用乘 137 右移 11 代替：分子最大 225，所有 16x16x16 组合的结果与浮点除法截断完全一致，
+// 乘积最大 30825，8 个像素可在 16 位通道内并行计算
+
+// 除以 15（截断），n 的范围 [0, 225]
+static inline uint32_t Div15(uint32_t n) {
+    return (n * 137) >> 11;
+}
+
+// 标量参考实现：混合一个像素
+static inline uint16_t Blend4444(uint16_t bg, uint16_t fg) {
+    uint32_t a = fg >> 12;
+    uint32_t inv = 15 - a;
+
+    uint32_t r = Div15((fg & 0xF) * a + (bg & 0xF) * inv);
+    uint32_t g = Div15(((fg >> 4) & 0xF) * a + ((bg >> 4) & 0xF) * inv);
+    uint32_t b = Div15(((fg >> 8) & 0xF) * a + ((bg >> 8) & 0xF) * inv);
+    uint32_t outA = a + (bg >> 12);
+    if (outA > 0xF) outA = 0xF;
+
+    return (uint16_t)(r | (g << 4) | (b << 8) | (outA << 12));
+}
+
+#if defined(__ARM_NEON)
+// 混合 8 个像素，结果与 Blend4444 逐像素一致
+static inline uint16x8_t Blend4444x8(uint16x8_t bg, uint16x8_t fg) {
+    const uint16x8_t mask = vdupq_n_u16(0xF);
+
+    uint16x8_t a = vshrq_n_u16(fg, 12);
+    uint16x8_t inv = vsubq_u16(mask, a);
+
+    // 每个通道：(fg * a + bg * inv) * 137 >> 11
+    uint16x8_t r = vmlaq_u16(vmulq_u16(vandq_u16(fg, mask), a), vandq_u16(bg, mask), inv);
+    uint16x8_t g = vmlaq_u16(vmulq_u16(vandq_u16(vshrq_n_u16(fg, 4), mask), a), vandq_u16(vshrq_n_u16(bg, 4), mask), inv);
+    uint16x8_t b = vmlaq_u16(vmulq_u16(vandq_u16(vshrq_n_u16(fg, 8), mask), a), vandq_u16(vshrq_n_u16(bg, 8), mask), inv);
+    r = vshrq_n_u16(vmulq_n_u16(r, 137), 11);
+    g = vshrq_n_u16(vmulq_n_u16(g, 137), 11);
+    b = vshrq_n_u16(vmulq_n_u16(b, 137), 11);
+
+    uint16x8_t outA = vminq_u16(vaddq_u16(a, vshrq_n_u16(bg, 12)), mask);
+
+    uint16x8_t out = vorrq_u16(r, vshlq_n_u16(g, 4));
+    out = vorrq_u16(out, vshlq_n_u16(b, 8));
+    return vorrq_u16(out, vshlq_n_u16(outA, 12));
+}
+#endif
+
+// 混合一行：bg[i] = Blend4444(bg[i], fg[i])，每次 8 个像素
+static inline void Blend4444Row(uint16_t* bg, const uint16_t* fg, uint32_t count) {
+    uint32_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8) {
+        vst1q_u16(bg + i, Blend4444x8(vld1q_u16(bg + i), vld1q_u16(fg + i)));
+    }
+#endif
+    for (; i < count; i++) bg[i] = Blend4444(bg[i], fg[i]);
+}
+
+// 混合一行（同一颜色）：bg[i] = Blend4444(bg[i], fg)
+static inline void Blend4444RowSolid(uint16_t* bg, uint16_t fg, uint32_t count) {
+    uint32_t i = 0;
+#if defined(__ARM_NEON)
+    uint16x8_t v = vdupq_n_u16(fg);
+    for (; i + 8 <= count; i += 8) {
+        vst1q_u16(bg + i, Blend4444x8(vld1q_u16(bg + i), v));
+    }
+#endif
+    for (; i < count; i++) bg[i] = Blend4444(bg[i], fg);
+}
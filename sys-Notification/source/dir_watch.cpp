@@ -0,0 +1,47 @@
+#include "dir_watch.hpp"
+#include <sys/stat.h>
+
+#ifdef __SWITCH__
+#include <switch.h>
+#endif
+
+bool PosixDirChangeDetector::HasChanged() {
+    struct stat st;
+    if (stat(m_Dir, &st) != 0) return true;
+    
+    m_Current = (uint64_t)st.st_mtim.tv_sec * 1000000000ULL + (uint64_t)st.st_mtim.tv_nsec;
+    return m_Force || m_Current != m_Baseline;
+}
+
+void PosixDirChangeDetector::Commit() {
+    m_Baseline = m_Current;
+    m_Force = false;
+}
+
+#ifdef __SWITCH__
+bool NativeDirChangeDetector::HasChanged() {
+    FsFileSystem* fs = fsdevGetDeviceFileSystem("sdmc");
+    if (!fs) return true;
+    
+    // 只统计文件（缓存子目录不计入）
+    FsDir dir;
+    if (R_FAILED(fsFsOpenDirectory(fs, m_Dir, FsDirOpenMode_ReadFiles | FsDirOpenMode_NoFileSize, &dir))) return true;
+    
+    s64 count = 0;
+    Result rc = fsDirGetEntryCount(&dir, &count);
+    fsDirClose(&dir);
+    if (R_FAILED(rc)) return true;
+    
+    m_Current = count;
+    return m_Force || m_Current != m_Baseline;
+}
+
+void NativeDirChangeDetector::Commit() {
+    m_Baseline = m_Current;
+    m_Force = false;
+}
+
+void NativeDirChangeDetector::NoteRemoved() {
+    if (m_Baseline > 0) m_Baseline--;
+}
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+// 目录变化检测：完整扫描目录之前先做一次廉价查询，没有变化就跳过扫描
+class DirChangeDetector {
+public:
+    virtual ~DirChangeDetector() = default;
+    
+    // 目录自上次 Commit 以来是否可能有变化（查询失败时返回 true，退回完整扫描）
+    virtual bool HasChanged() = 0;
+    
+    // 完整扫描之后调用：以 HasChanged 时查询到的状态为基准
+    virtual void Commit() = 0;
+    
+    // 本模块删除了一个文件（调整基准，避免与新增文件相互抵消）
+    virtual void NoteRemoved() {}
+    
+    // 下一次查询强制返回有变化（目录中有写入中的临时文件或未收集完的文件时）
+    void ForceRescan() { m_Force = true; }
+    
+protected:
+    bool m_Force = true;              // 首次查询总是扫描
+};
+
+// POSIX 实现：比较目录修改时间（创建、删除、重命名都会更新）
+class PosixDirChangeDetector : public DirChangeDetector {
+public:
+    explicit PosixDirChangeDetector(const char* dir) : m_Dir(dir) {}
+    
+    bool HasChanged() override;
+    void Commit() override;
+    
+private:
+    const char* m_Dir;
+    uint64_t m_Current = 0;           // 最近一次查询到的修改时间（纳秒）
+    uint64_t m_Baseline = 0;          // 上次扫描时的修改时间
+};
+
+#ifdef __SWITCH__
+// 原生实现：fsDirGetEntryCount 查询文件数（打开、查询、关闭目录共三次 IPC，不读取目录项）
+// SD 卡上的目录没有可靠的修改时间，所以比较文件数
+class NativeDirChangeDetector : public DirChangeDetector {
+public:
+    explicit NativeDirChangeDetector(const char* dir) : m_Dir(dir) {}
+    
+    bool HasChanged() override;
+    void Commit() override;
+    void NoteRemoved() override;
+    
+private:
+    const char* m_Dir;                // SD 卡上的路径（不含 sdmc: 前缀）
+    int64_t m_Current = 0;            // 最近一次查询到的文件数
+    int64_t m_Baseline = -1;          // 上次扫描时的文件数
+};
+
+typedef NativeDirChangeDetector DefaultDirChangeDetector;
+#else
+typedef PosixDirChangeDetector DefaultDirChangeDetector;
+#endif
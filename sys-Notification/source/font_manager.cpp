@@ -0,0 +1,165 @@
+// STB TrueType 实现（只在这个编译单元中展开）
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "font_manager.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+// 持久化字形缓存文件格式：
+//   GlyphCacheFileHeader
+//   GlyphCacheFileRecord + width * height 字节覆盖率位图（重复 count 次，按最近使用时间从旧到新）
+#define GLYPH_CACHE_FILE_MAGIC 0x434C474E  // "NGLC"
+
+// 文件大小上限：缓存本身受条目数和位图预算限制，文件不会超过它
+#define GLYPH_CACHE_FILE_MAX (sizeof(GlyphCacheFileHeader) + GLYPH_CACHE_ENTRIES * sizeof(GlyphCacheFileRecord) + GLYPH_CACHE_BUDGET)
+
+namespace {
+
+struct GlyphCacheFileHeader {
+    u32 magic;
+    u32 version;
+    u64 langCode;                  // 系统语言
+    u32 fontIdentity[3];           // 三个共享字体的身份
+    u32 count;                     // 记录数
+};
+
+struct GlyphCacheFileRecord {
+    s32 glyphIndex;
+    float fontSize;
+    u16 width;
+    u16 height;
+    s16 xoffset;
+    s16 yoffset;
+    s16 advance;
+    u8 fontId;
+    u8 reserved;
+};
+
+}
+
+// 加载持久化字形缓存
+bool FontManager::LoadGlyphCache(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    
+    // 检查文件大小
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileSize < (long)sizeof(GlyphCacheFileHeader) || fileSize > (long)GLYPH_CACHE_FILE_MAX) {
+        fclose(file);
+        return false;
+    }
+    
+    // 检查版本、系统语言和共享字体身份
+    GlyphCacheFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != GLYPH_CACHE_FILE_MAGIC ||
+        header.version != GLYPH_CACHE_FILE_VERSION ||
+        header.langCode != m_LangCode ||
+        header.fontIdentity[FONT_ID_STD] != m_FontIdentity[FONT_ID_STD] ||
+        header.fontIdentity[FONT_ID_LOCAL] != m_FontIdentity[FONT_ID_LOCAL] ||
+        header.fontIdentity[FONT_ID_EXT] != m_FontIdentity[FONT_ID_EXT] ||
+        header.count > GLYPH_CACHE_ENTRIES) {
+        fclose(file);
+        return false;
+    }
+    
+    // 逐条读入缓存（记录损坏时停止，已读入的保留）
+    for (u32 i = 0; i < header.count; i++) {
+        GlyphCacheFileRecord record;
+        if (fread(&record, sizeof(record), 1, file) != 1) break;
+        
+        stbtt_fontinfo* font = IdToFont(record.fontId);
+        u32 bytes = (u32)record.width * record.height;
+        if (!font || bytes > GLYPH_CACHE_BUDGET) break;
+        
+        // 位图必须用 stb_truetype 的分配器，淘汰时由 stbtt_FreeBitmap 释放（空白字形没有位图）
+        u8* data = nullptr;
+        if (bytes > 0) {
+            data = (u8*)STBTT_malloc(bytes, nullptr);
+            if (!data) break;
+            if (fread(data, 1, bytes, file) != bytes) {
+                STBTT_free(data, nullptr);
+                break;
+            }
+        }
+        
+        GlyphBitmap glyph = {data, record.width, record.height, record.xoffset, record.yoffset, record.advance, false};
+        CacheGlyph(font, record.glyphIndex, record.fontSize, glyph);
+        if (!glyph.cached) STBTT_free(data, nullptr);
+    }
+    
+    fclose(file);
+    
+    // 刚从文件读入的内容无需写回
+    m_CacheDirty = false;
+    return true;
+}
+
+// 写回持久化字形缓存
+bool FontManager::SaveGlyphCache(const char* path) {
+    if (!m_CacheDirty) return true;
+    
+    char tempPath[256];
+    snprintf(tempPath, sizeof(tempPath), "%s.temp", path);
+    
+    FILE* file = fopen(tempPath, "wb");
+    if (!file) return false;
+    
+    // 按最近使用时间从旧到新排列，加载后 LRU 顺序不变
+    const GlyphCacheEntry* order[GLYPH_CACHE_ENTRIES];
+    u32 count = 0;
+    for (int i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+        if (!m_CacheEntries[i].used) continue;
+        u32 j = count++;
+        while (j > 0 && order[j - 1]->lastUse > m_CacheEntries[i].lastUse) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = &m_CacheEntries[i];
+    }
+    
+    GlyphCacheFileHeader header;
+    header.magic = GLYPH_CACHE_FILE_MAGIC;
+    header.version = GLYPH_CACHE_FILE_VERSION;
+    header.langCode = m_LangCode;
+    header.fontIdentity[FONT_ID_STD] = m_FontIdentity[FONT_ID_STD];
+    header.fontIdentity[FONT_ID_LOCAL] = m_FontIdentity[FONT_ID_LOCAL];
+    header.fontIdentity[FONT_ID_EXT] = m_FontIdentity[FONT_ID_EXT];
+    header.count = count;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    
+    for (u32 i = 0; i < count && ok; i++) {
+        const GlyphCacheEntry& e = *order[i];
+        GlyphCacheFileRecord record;
+        record.glyphIndex = e.glyphIndex;
+        record.fontSize = e.fontSize;
+        record.width = (u16)e.glyph.width;
+        record.height = (u16)e.glyph.height;
+        record.xoffset = (s16)e.glyph.xoffset;
+        record.yoffset = (s16)e.glyph.yoffset;
+        record.advance = (s16)e.glyph.advance;
+        record.fontId = (u8)FontToId(e.font);
+        record.reserved = 0;
+        ok = fwrite(&record, sizeof(record), 1, file) == 1 &&
+             fwrite(e.glyph.data, 1, e.bytes, file) == e.bytes;
+    }
+    
+    if (fclose(file) != 0) ok = false;
+    
+    // 写入失败时删除临时文件，保留旧缓存
+    if (!ok) {
+        remove(tempPath);
+        return false;
+    }
+    
+    remove(path);
+    if (rename(tempPath, path) != 0) {
+        remove(tempPath);
+        return false;
+    }
+    
+    m_CacheDirty = false;
+    return true;
+}
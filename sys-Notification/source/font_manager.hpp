@@ -2,10 +2,22 @@
 
 #include <switch.h>
 
-// STB TrueType 实现
-#define STB_TRUETYPE_IMPLEMENTATION
+// STB TrueType（实现在 font_manager.cpp 中编译一次）
 #include "stb_truetype.h"
 
+// 字形缓存配置（位图由 stb_truetype 在堆上分配，总量受预算限制）
+#define GLYPH_CACHE_ENTRIES  48          // 最多缓存的字形数
+#define GLYPH_CACHE_BUDGET   0x4000      // 位图总字节预算（16 KB）
+
+// 码点解析缓存条目数（直接映射，必须是 2 的幂）
+#define GLYPH_RESOLVE_ENTRIES 128
+
+// 持久化字形缓存文件格式版本（格式变化时递增，旧文件自动失效）
+#define GLYPH_CACHE_FILE_VERSION 1
+
+// 字体度量缓存条目数（字体 x 字号组合，目前只用到 图标40 / 文本28 两种字号）
+#define FONT_METRICS_ENTRIES 8
+
 // 字体管理器（单例）
 // 负责加载和管理 Switch 系统共享字体，全局只初始化一次
 class FontManager {
@@ -18,6 +30,16 @@ public:
         int xoffset;        // X 偏移
         int yoffset;        // Y 偏移
         int advance;        // 字符前进距离
+        bool cached;        // 位图是否由缓存持有（持有时不能释放）
+    };
+    
+    // 字体在某个字号下的度量（像素）
+    struct FontMetrics {
+        const stbtt_fontinfo* font;
+        float fontSize;
+        float scale;        // 缩放比例（CalculateScaleForVisibleHeight 的结果）
+        float ascent;       // 基线以上高度
+        float descent;      // 基线以下高度（负值）
     };
     
     // 获取单例实例（第一次调用时自动加载字体）
@@ -54,55 +76,141 @@ public:
         return fontSize / capHeight;
     }
     
+    // 获取字体在某个字号下的缩放比例和垂直度量（按字体和字号缓存）
+    // 按值返回：缓存条目会被之后的查询覆盖
+    FontMetrics GetFontMetrics(stbtt_fontinfo* font, float fontSize) {
+        for (int i = 0; i < m_MetricsCount; i++) {
+            if (m_Metrics[i].font == font && m_Metrics[i].fontSize == fontSize) return m_Metrics[i];
+        }
+        
+        // 未命中：计算并放入缓存（满了则覆盖最早的条目）
+        int slot = (m_MetricsCount < FONT_METRICS_ENTRIES) ? m_MetricsCount++ : (m_MetricsNext++ % FONT_METRICS_ENTRIES);
+        FontMetrics& m = m_Metrics[slot];
+        int ascent, descent, lineGap;
+        stbtt_GetFontVMetrics(font, &ascent, &descent, &lineGap);
+        m.font = font;
+        m.fontSize = fontSize;
+        m.scale = CalculateScaleForVisibleHeight(font, fontSize);
+        m.ascent = ascent * m.scale;
+        m.descent = descent * m.scale;
+        return m;
+    }
+    
+    // 码点解析结果：由哪个字体的哪个字形绘制
+    struct ResolvedGlyph {
+        u32 codepoint;
+        stbtt_fontinfo* font;      // 为空表示条目未使用
+        int glyphIndex;
+    };
+    
+    // 解析码点（直接映射缓存，未命中时才在字体链中查 cmap）
+    // 按值返回：同一槽位会被之后解析的其他码点覆盖
+    ResolvedGlyph ResolveGlyph(u32 codepoint) {
+        ResolvedGlyph& r = m_Resolved[((codepoint * 2654435761u) >> 25) & (GLYPH_RESOLVE_ENTRIES - 1)];
+        if (r.font && r.codepoint == codepoint) return r;
+        
+        r.codepoint = codepoint;
+        r.font = PickFontForCodepoint(codepoint, &r.glyphIndex);
+        return r;
+    }
+    
+    // 获取字符前进距离（只读水平度量，不光栅化）
+    int GetGlyphAdvance(u32 codepoint, float fontSize) {
+        ResolvedGlyph r = ResolveGlyph(codepoint);
+        
+        int advance, leftSideBearing;
+        stbtt_GetGlyphHMetrics(r.font, r.glyphIndex, &advance, &leftSideBearing);
+        return (int)(advance * GetFontMetrics(r.font, fontSize).scale);
+    }
+    
     // 根据码点渲染字形位图（自动选择字体）
+    // 返回的位图在下一次 RenderGlyph 调用前有效（之后可能被缓存淘汰）
     GlyphBitmap RenderGlyph(u32 codepoint, float fontSize) {
-        GlyphBitmap glyph = {nullptr, 0, 0, 0, 0, 0};
+        ResolvedGlyph resolved = ResolveGlyph(codepoint);
+        return RenderGlyph(resolved.font, resolved.glyphIndex, fontSize);
+    }
+    
+    // 渲染已解析的字形（供排版结果重放使用，跳过码点解析）
+    GlyphBitmap RenderGlyph(stbtt_fontinfo* font, int glyphIndex, float fontSize) {
+        GlyphBitmap glyph = {nullptr, 0, 0, 0, 0, 0, false};
         
-        // 选择字体
-        stbtt_fontinfo* font = PickFontForCodepoint(codepoint);
-        if (!font) return glyph;
+        // 先查缓存
+        GlyphCacheEntry* entry = FindCachedGlyph(font, glyphIndex, fontSize);
+        if (entry) {
+            m_CacheHits++;
+            entry->lastUse = ++m_UseClock;
+            return entry->glyph;
+        }
+        m_CacheMisses++;
         
-        // 计算缩放比例（基于大写字母高度，让 fontSize 代表实际可见高度）
-        float scale = CalculateScaleForVisibleHeight(font, fontSize);
+        // 缩放比例（基于大写字母高度，让 fontSize 代表实际可见高度）
+        float scale = GetFontMetrics(font, fontSize).scale;
         
         // 获取字形位图
-        glyph.data = stbtt_GetCodepointBitmap(
+        glyph.data = stbtt_GetGlyphBitmap(
             font, 
             scale, scale,
-            (int)codepoint,
+            glyphIndex,
             &glyph.width, &glyph.height,
             &glyph.xoffset, &glyph.yoffset
         );
         
         // 获取字符前进距离
         int leftSideBearing;
-        stbtt_GetCodepointHMetrics(font, (int)codepoint, &glyph.advance, &leftSideBearing);
+        stbtt_GetGlyphHMetrics(font, glyphIndex, &glyph.advance, &leftSideBearing);
         glyph.advance = (int)(glyph.advance * scale);
         
+        // 放入缓存（放不下时由调用者释放）
+        CacheGlyph(font, glyphIndex, fontSize, glyph);
         return glyph;
     }
     
-    // 释放字形位图
+    // 字形位图相对笔位置的范围 [x0, x1) x [y0, y1)，与 RenderGlyph 的位图一致，但不光栅化
+    void GetGlyphBox(stbtt_fontinfo* font, int glyphIndex, float fontSize, int* x0, int* y0, int* x1, int* y1) {
+        float scale = GetFontMetrics(font, fontSize).scale;
+        stbtt_GetGlyphBitmapBox(font, glyphIndex, scale, scale, x0, y0, x1, y1);
+    }
+    
+    // 释放字形位图（缓存持有的位图由缓存管理，这里不释放）
     void FreeGlyph(GlyphBitmap& glyph) {
-        if (glyph.data) {
+        if (glyph.data && !glyph.cached) {
             stbtt_FreeBitmap(glyph.data, nullptr);
-            glyph.data = nullptr;
         }
+        glyph.data = nullptr;
+    }
+    
+    // 字形缓存命中/未命中次数
+    u32 GetCacheHits() const { return m_CacheHits; }
+    u32 GetCacheMisses() const { return m_CacheMisses; }
+    
+    // 字体组合身份（共享字体 + 系统语言），字体变化后已渲染的面板随之失效
+    u32 GetFontSetIdentity() const {
+        u32 hash = (u32)m_LangCode ^ (u32)(m_LangCode >> 32);
+        for (int i = 0; i < FONT_ID_COUNT; i++) hash = (hash ^ m_FontIdentity[i]) * 16777619u;
+        return hash;
     }
     
+    // 从 SD 卡加载持久化字形缓存（版本、共享字体或系统语言不匹配时忽略，照常实时光栅化）
+    bool LoadGlyphCache(const char* path);
+    
+    // 缓存中有新光栅化的字形时写回 SD 卡（先写临时文件再重命名）
+    bool SaveGlyphCache(const char* path);
+    
 private:
     // 构造函数：加载所有字体
-    FontManager() : m_HasLocalFont(false), m_HasExtFont(false) {
+    FontManager() : m_HasLocalFont(false), m_HasExtFont(false), m_CacheEntries{}, m_CacheBytes(0), m_UseClock(0), m_CacheHits(0), m_CacheMisses(0), m_Metrics{}, m_MetricsCount(0), m_MetricsNext(0), m_Resolved{}, m_CacheDirty(false), m_LangCode(0), m_FontIdentity{} {
         PlFontData font;
         
         // 1. 加载标准字体（英文、数字、基本符号）
         if (R_SUCCEEDED(plGetSharedFontByType(&font, PlSharedFontType_Standard))) {
             stbtt_InitFont(&m_FontStd, (u8*)font.address, stbtt_GetFontOffsetForIndex((u8*)font.address, 0));
+            m_FontIdentity[FONT_ID_STD] = FontIdentity(font);
         }
         
         // 2. 加载任天堂扩展字体（图标和特殊符号）
         if (R_SUCCEEDED(plGetSharedFontByType(&font, PlSharedFontType_NintendoExt))) {
             stbtt_InitFont(&m_FontExt, (u8*)font.address, stbtt_GetFontOffsetForIndex((u8*)font.address, 0));
+            m_FontIdentity[FONT_ID_EXT] = FontIdentity(font);
             m_HasExtFont = true;
         }
         
@@ -134,38 +242,152 @@ private:
             // 加载对应的本地化字体
             if (type != PlSharedFontType_Standard && R_SUCCEEDED(plGetSharedFontByType(&font, type))) {
                 stbtt_InitFont(&m_FontLocal, (u8*)font.address, stbtt_GetFontOffsetForIndex((u8*)font.address, 0));
+                m_FontIdentity[FONT_ID_LOCAL] = FontIdentity(font);
                 m_HasLocalFont = true;
             }
+            m_LangCode = langCode;
         }
     }
     
-    ~FontManager() = default;
+    // 字体编号（持久化缓存中用编号代替指针）
+    enum { FONT_ID_STD = 0, FONT_ID_LOCAL = 1, FONT_ID_EXT = 2, FONT_ID_COUNT = 3 };
+    
+    // 共享字体身份：数据大小 + 文件头哈希（系统更新替换字体后失效）
+    static u32 FontIdentity(const PlFontData& font) {
+        const u8* p = (const u8*)font.address;
+        u32 hash = 2166136261u ^ font.size;
+        for (u32 i = 0; i < 256 && i < font.size; i++) hash = (hash ^ p[i]) * 16777619u;
+        return hash;
+    }
+    
+    // 字体指针和编号互相转换
+    int FontToId(const stbtt_fontinfo* font) const {
+        if (font == &m_FontLocal) return FONT_ID_LOCAL;
+        if (font == &m_FontExt) return FONT_ID_EXT;
+        return FONT_ID_STD;
+    }
+    stbtt_fontinfo* IdToFont(int id) {
+        if (id == FONT_ID_LOCAL) return m_HasLocalFont ? &m_FontLocal : nullptr;
+        if (id == FONT_ID_EXT) return m_HasExtFont ? &m_FontExt : nullptr;
+        return &m_FontStd;
+    }
+    
+    ~FontManager() {
+        for (int i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+            if (m_CacheEntries[i].used) stbtt_FreeBitmap(m_CacheEntries[i].glyph.data, nullptr);
+        }
+    }
     
     // 禁止拷贝和赋值（单例模式）
     FontManager(const FontManager&) = delete;
     FontManager& operator=(const FontManager&) = delete;
     
-    // 根据码点选择字体（优先级：本地化 > 扩展 > 标准）
-    stbtt_fontinfo* PickFontForCodepoint(u32 codepoint) {
+    // 根据码点选择字体（优先级：本地化 > 扩展 > 标准），同时输出字形索引
+    stbtt_fontinfo* PickFontForCodepoint(u32 codepoint, int* outGlyphIndex) {
         // 1. 优先检查本地化字体（中文、韩文等）
-        if (m_HasLocalFont && stbtt_FindGlyphIndex(&m_FontLocal, (int)codepoint) != 0) {
+        if (m_HasLocalFont && (*outGlyphIndex = stbtt_FindGlyphIndex(&m_FontLocal, (int)codepoint)) != 0) {
             return &m_FontLocal;
         }
         
         // 2. 检查扩展字体（图标和特殊符号）
-        if (m_HasExtFont && stbtt_FindGlyphIndex(&m_FontExt, (int)codepoint) != 0) {
+        if (m_HasExtFont && (*outGlyphIndex = stbtt_FindGlyphIndex(&m_FontExt, (int)codepoint)) != 0) {
             return &m_FontExt;
         }
         
         // 3. 回退到标准字体
+        *outGlyphIndex = stbtt_FindGlyphIndex(&m_FontStd, (int)codepoint);
         return &m_FontStd;
     }
     
+    // 字形缓存条目，键为（字体，字形索引，字号）
+    struct GlyphCacheEntry {
+        const stbtt_fontinfo* font;
+        int glyphIndex;
+        float fontSize;
+        GlyphBitmap glyph;
+        u32 bytes;                 // 位图字节数
+        u32 lastUse;               // 最近使用时间（用于 LRU 淘汰）
+        bool used;
+    };
+    
+    // 查找缓存条目
+    GlyphCacheEntry* FindCachedGlyph(const stbtt_fontinfo* font, int glyphIndex, float fontSize) {
+        for (int i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+            GlyphCacheEntry& e = m_CacheEntries[i];
+            if (e.used && e.font == font && e.glyphIndex == glyphIndex && e.fontSize == fontSize) return &e;
+        }
+        return nullptr;
+    }
+    
+    // 淘汰最久未使用的条目，没有可淘汰的返回 false
+    bool EvictLeastRecentlyUsed() {
+        GlyphCacheEntry* victim = nullptr;
+        for (int i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+            GlyphCacheEntry& e = m_CacheEntries[i];
+            if (e.used && (!victim || e.lastUse < victim->lastUse)) victim = &e;
+        }
+        if (!victim) return false;
+        
+        stbtt_FreeBitmap(victim->glyph.data, nullptr);
+        m_CacheBytes -= victim->bytes;
+        victim->used = false;
+        return true;
+    }
+    
+    // 放入缓存：超出预算或条目已满时按 LRU 淘汰；单个位图超过预算则不缓存
+    void CacheGlyph(const stbtt_fontinfo* font, int glyphIndex, float fontSize, GlyphBitmap& glyph) {
+        u32 bytes = (u32)(glyph.width * glyph.height);
+        if (bytes > GLYPH_CACHE_BUDGET) return;
+        
+        while (m_CacheBytes + bytes > GLYPH_CACHE_BUDGET) {
+            if (!EvictLeastRecentlyUsed()) return;
+        }
+        
+        GlyphCacheEntry* slot = nullptr;
+        while (!slot) {
+            for (int i = 0; i < GLYPH_CACHE_ENTRIES && !slot; i++) {
+                if (!m_CacheEntries[i].used) slot = &m_CacheEntries[i];
+            }
+            if (!slot && !EvictLeastRecentlyUsed()) return;
+        }
+        
+        glyph.cached = true;
+        slot->font = font;
+        slot->glyphIndex = glyphIndex;
+        slot->fontSize = fontSize;
+        slot->glyph = glyph;
+        slot->bytes = bytes;
+        slot->lastUse = ++m_UseClock;
+        slot->used = true;
+        m_CacheBytes += bytes;
+        m_CacheDirty = true;
+    }
+    
     // 字体对象（只保存指向系统共享内存的指针，不占用大量内存）
     stbtt_fontinfo m_FontStd;      // 标准字体（英文、数字、基本符号）
     stbtt_fontinfo m_FontLocal;    // 本地化字体（中文、韩文等）
     stbtt_fontinfo m_FontExt;      // 扩展字体（任天堂图标和特殊符号）
     bool m_HasLocalFont;           // 本地化字体是否已加载
     bool m_HasExtFont;             // 扩展字体是否已加载
+    
+    // 字形缓存
+    GlyphCacheEntry m_CacheEntries[GLYPH_CACHE_ENTRIES];
+    u32 m_CacheBytes;              // 当前缓存位图总字节数
+    u32 m_UseClock;                // LRU 计数器
+    u32 m_CacheHits;               // 命中次数
+    u32 m_CacheMisses;             // 未命中次数
+    
+    // 字体度量缓存
+    FontMetrics m_Metrics[FONT_METRICS_ENTRIES];
+    int m_MetricsCount;            // 已使用条目数
+    int m_MetricsNext;             // 满了之后下一个覆盖的位置
+    
+    // 码点解析缓存
+    ResolvedGlyph m_Resolved[GLYPH_RESOLVE_ENTRIES];
+    
+    // 持久化缓存
+    bool m_CacheDirty;             // 有新字形尚未写回 SD 卡
+    u64 m_LangCode;                // 系统语言（决定本地化字体）
+    u32 m_FontIdentity[FONT_ID_COUNT];
 };
 
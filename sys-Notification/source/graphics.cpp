@@ -1,5 +1,12 @@
 #include "graphics.hpp"
 #include "font_manager.hpp"
+#include "blend4444.hpp"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 // 构造函数：轻量级初始化
 GraphicsRenderer::GraphicsRenderer() 
@@ -8,11 +15,14 @@ GraphicsRenderer::GraphicsRenderer()
     , m_CurrentFramebuffer(nullptr)
     , m_Width(0)
     , m_Height(0)
-    , m_ScissorEnabled(false)
-    , m_ScissorX(0)
-    , m_ScissorY(0)
-    , m_ScissorW(0)
-    , m_ScissorH(0)
+    , m_LinearSurface(nullptr)
+    , m_Target(nullptr)
+    , m_TargetLinear(false)
+    , m_LinearComposition(false)
+    , m_Clip{0, 0, 0, 0}
+    , m_ClipDepth(0)
+    , m_CornerRadius(-1)
+    , m_GlyphLutColor(0x10000)
 {
     // 预初始化字体管理器（确保在绘制前字体已加载）
     FontManager::Instance();
@@ -28,24 +38,68 @@ void GraphicsRenderer::Bind(Framebuffer* fb, Event* vsyncEvent, u16 width, u16 h
     m_VsyncEvent = vsyncEvent;
     m_Width = width;
     m_Height = height;
+    
+    // 裁剪区域重置为整个屏幕
+    m_Clip = {0, 0, (s32)width, (s32)height};
+    m_ClipDepth = 0;
+}
+
+// 绑定线性合成表面
+void GraphicsRenderer::BindLinearSurface(u16* pixels) {
+    m_LinearSurface = pixels;
+    if (!pixels) m_LinearComposition = false;
+}
+
+// 启用线性合成模式
+void GraphicsRenderer::EnableLinearComposition() {
+    m_LinearComposition = (m_LinearSurface != nullptr);
+}
+
+// 禁用线性合成模式
+void GraphicsRenderer::DisableLinearComposition() {
+    m_LinearComposition = false;
 }
 
 // 开始绘制帧
 void GraphicsRenderer::StartFrame() {
     if (m_Framebuffer) {
         m_CurrentFramebuffer = framebufferBegin(m_Framebuffer, nullptr);
+        
+        // 线性合成模式下绘制到线性表面，否则直接绘制到块线性帧缓冲
+        m_TargetLinear = m_LinearComposition;
+        m_Target = m_TargetLinear ? m_LinearSurface : (u16*)m_CurrentFramebuffer;
     }
 }
 
 // 提交并显示帧
 void GraphicsRenderer::EndFrame() {
     if (m_Framebuffer && m_VsyncEvent) {
+        // 线性合成模式：一次性转换为块线性
+        if (m_TargetLinear && m_CurrentFramebuffer) {
+            SwizzleBlit((u16*)m_CurrentFramebuffer, m_LinearSurface);
+        }
         eventWait(m_VsyncEvent, UINT64_MAX);
         framebufferEnd(m_Framebuffer);
         m_CurrentFramebuffer = nullptr;
+        m_Target = nullptr;
+        m_TargetLinear = false;
     }
 }
 
+// 开始离屏绘制
+void GraphicsRenderer::StartOffscreen() {
+    if (!m_LinearSurface) return;
+    m_TargetLinear = true;
+    m_Target = m_LinearSurface;
+}
+
+// 结束离屏绘制
+void GraphicsRenderer::EndOffscreen() {
+    if (!m_TargetLinear) return;
+    m_TargetLinear = false;
+    m_Target = nullptr;
+}
+
 // 将 Color 结构转换为 RGBA4444 格式（16位）
 inline u16 GraphicsRenderer::ColorToU16(Color c) {
     return (u16)((c.r & 0xF) | ((c.g & 0xF) << 4) | ((c.b & 0xF) << 8) | ((c.a & 0xF) << 12));
@@ -61,60 +115,244 @@ inline Color GraphicsRenderer::ColorFromU16(u16 raw) {
     return c;
 }
 
-// 颜色混合（Alpha 混合）
-inline u8 GraphicsRenderer::BlendColor(u8 src, u8 dst, u8 alpha) {
-    u8 oneMinusAlpha = 0x0F - alpha;
-    return (u8)((dst * alpha + src * oneMinusAlpha) / (float)0xF);
-}
-
-// 将 x,y 坐标映射为块线性帧缓冲中的偏移
+// 将 x,y 坐标映射为块线性帧缓冲中的偏移（线性表面为行主序偏移）
 u32 GraphicsRenderer::GetPixelOffset(s32 x, s32 y) {
+    if (m_TargetLinear) return (u32)y * m_Width + x;
+    
     u32 tmpPos = ((y & 127) / 16) + (x / 32 * 8) + ((y / 16 / 8) * (((m_Width / 2) / 16 * 8)));
     tmpPos *= 16 * 16 * 4;
     tmpPos += ((y % 16) / 8) * 512 + ((x % 32) / 16) * 256 + ((y % 8) / 2) * 64 + ((x % 16) / 8) * 32 + (y % 2) * 16 + (x % 8) * 2;
     return tmpPos / 2;
 }
 
+// GOB 起始偏移：与 GetPixelOffset 相同的映射，只是以 GOB 为单位计算一次
+// gobX = x / 32, gobY = y / 8，返回值以 u16 为单位
+u32 GraphicsRenderer::GetGobOffset(s32 gobX, s32 gobY) {
+    u32 tmpPos = ((gobY & 15) / 2) + (gobX * 8) + ((gobY / 16) * ((m_Width / 32) * 8));
+    tmpPos *= 16 * 16 * 4;
+    tmpPos += (gobY & 1) * 512;
+    return tmpPos / 2;
+}
+
+// 按 GOB 顺序填充矩形
+// GOB 内部布局（u16 单位）：每 8 个连续像素占连续 16 字节，
+//   行偏移 = (ly / 2) * 32 + (ly % 2) * 8，段偏移 = (seg / 2) * 128 + (seg % 2) * 16
+void GraphicsRenderer::FillSpanRect(s32 x0, s32 y0, s32 x1, s32 y1, u16 raw) {
+    if (x0 >= x1 || y0 >= y1 || m_Target == nullptr) return;
+    
+    // 线性表面：逐行连续填充
+    if (m_TargetLinear) {
+        for (s32 y = y0; y < y1; y++) {
+            u16* row = m_Target + (u32)y * m_Width;
+            for (s32 x = x0; x < x1; x++) row[x] = raw;
+        }
+        return;
+    }
+    
+    u16* fb = m_Target;
+    
+    // 16 字节填充模板（8 个像素）
+    u16 pattern[8];
+    for (int i = 0; i < 8; i++) pattern[i] = raw;
+    
+    for (s32 gy = y0 / 8; gy <= (y1 - 1) / 8; gy++) {
+        s32 rowTop = gy * 8;
+        s32 ly0 = (y0 > rowTop) ? y0 - rowTop : 0;
+        s32 ly1 = (y1 < rowTop + 8) ? y1 - rowTop : 8;
+        
+        for (s32 gx = x0 / 32; gx <= (x1 - 1) / 32; gx++) {
+            s32 colLeft = gx * 32;
+            s32 lx0 = (x0 > colLeft) ? x0 - colLeft : 0;
+            s32 lx1 = (x1 < colLeft + 32) ? x1 - colLeft : 32;
+            
+            u16* gob = fb + GetGobOffset(gx, gy);
+            
+            // 整块 GOB 被覆盖：512 字节连续写入
+            if (ly0 == 0 && ly1 == 8 && lx0 == 0 && lx1 == 32) {
+                for (int i = 0; i < 256; i += 8) {
+                    memcpy(gob + i, pattern, sizeof(pattern));
+                }
+                continue;
+            }
+            
+            // 部分覆盖：逐行、逐 8 像素段处理
+            for (s32 ly = ly0; ly < ly1; ly++) {
+                u16* row = gob + (ly / 2) * 32 + (ly % 2) * 8;
+                for (s32 seg = lx0 / 8; seg <= (lx1 - 1) / 8; seg++) {
+                    u16* dst = row + (seg / 2) * 128 + (seg % 2) * 16;
+                    s32 sx0 = (lx0 > seg * 8) ? lx0 - seg * 8 : 0;
+                    s32 sx1 = (lx1 < seg * 8 + 8) ? lx1 - seg * 8 : 8;
+                    if (sx0 == 0 && sx1 == 8) {
+                        memcpy(dst, pattern, sizeof(pattern));
+                    } else {
+                        for (s32 i = sx0; i < sx1; i++) dst[i] = raw;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 按 GOB 顺序混合矩形（同一颜色），遍历方式与 FillSpanRect 相同
+// 线性表面整行、块线性每 8 像素段交给定点混合内核（NEON 一次 8 个像素）
+void GraphicsRenderer::BlendSpanRect(s32 x0, s32 y0, s32 x1, s32 y1, u16 raw) {
+    if (x0 >= x1 || y0 >= y1 || m_Target == nullptr) return;
+    
+    // 线性表面：逐行连续混合
+    if (m_TargetLinear) {
+        for (s32 y = y0; y < y1; y++) {
+            Blend4444RowSolid(m_Target + (u32)y * m_Width + x0, raw, x1 - x0);
+        }
+        return;
+    }
+    
+    for (s32 gy = y0 / 8; gy <= (y1 - 1) / 8; gy++) {
+        s32 rowTop = gy * 8;
+        s32 ly0 = (y0 > rowTop) ? y0 - rowTop : 0;
+        s32 ly1 = (y1 < rowTop + 8) ? y1 - rowTop : 8;
+        
+        for (s32 gx = x0 / 32; gx <= (x1 - 1) / 32; gx++) {
+            s32 colLeft = gx * 32;
+            s32 lx0 = (x0 > colLeft) ? x0 - colLeft : 0;
+            s32 lx1 = (x1 < colLeft + 32) ? x1 - colLeft : 32;
+            
+            u16* gob = m_Target + GetGobOffset(gx, gy);
+            
+            for (s32 ly = ly0; ly < ly1; ly++) {
+                u16* row = gob + (ly / 2) * 32 + (ly % 2) * 8;
+                for (s32 seg = lx0 / 8; seg <= (lx1 - 1) / 8; seg++) {
+                    u16* dst = row + (seg / 2) * 128 + (seg % 2) * 16;
+                    s32 sx0 = (lx0 > seg * 8) ? lx0 - seg * 8 : 0;
+                    s32 sx1 = (lx1 < seg * 8 + 8) ? lx1 - seg * 8 : 8;
+                    Blend4444RowSolid(dst + sx0, raw, sx1 - sx0);
+                }
+            }
+        }
+    }
+}
+
+// 混合一行像素：线性目标整行连续，块线性目标每 8 像素（16 字节）连续
+void GraphicsRenderer::BlendSpanRow(s32 x, s32 y, const u16* fg, s32 count) {
+    if (m_TargetLinear) {
+        Blend4444Row(m_Target + (u32)y * m_Width + x, fg, count);
+        return;
+    }
+    
+    while (count > 0) {
+        s32 n = 8 - (x & 7);
+        if (n > count) n = count;
+        Blend4444Row(m_Target + GetPixelOffset(x, y), fg, n);
+        x += n;
+        fg += n;
+        count -= n;
+    }
+}
+
+// 线性表面 -> 块线性帧缓冲
+// 每个 GOB 行（32 像素）在线性表面中连续 64 字节，在块线性中拆成 4 段 16 字节：
+//   段偏移（u16 单位）分别为 0, 16, 128, 144
+void GraphicsRenderer::SwizzleBlit(u16* dst, const u16* src) {
+    s32 gobCols = m_Width / 32;
+    
+    for (s32 y = 0; y < (s32)m_Height; y++) {
+        s32 gy = y / 8;
+        s32 ly = y % 8;
+        u32 rowOffset = (ly / 2) * 32 + (ly % 2) * 8;
+        const u16* in = src + (u32)y * m_Width;
+        
+        for (s32 gx = 0; gx < gobCols; gx++, in += 32) {
+            u16* out = dst + GetGobOffset(gx, gy) + rowOffset;
+#if defined(__ARM_NEON)
+            uint16x8x4_t v = vld1q_u16_x4(in);
+            vst1q_u16(out + 0,   v.val[0]);
+            vst1q_u16(out + 16,  v.val[1]);
+            vst1q_u16(out + 128, v.val[2]);
+            vst1q_u16(out + 144, v.val[3]);
+#else
+            memcpy(out + 0,   in + 0,  16);
+            memcpy(out + 16,  in + 8,  16);
+            memcpy(out + 128, in + 16, 16);
+            memcpy(out + 144, in + 24, 16);
+#endif
+        }
+    }
+}
+
+// 线性表面区域 -> 当前帧（块线性），支持任意平移
+// 目标按 8 像素对齐分段：整段 16 字节拷贝，边缘段逐像素拷贝
+void GraphicsRenderer::BlitLinear(s32 srcX, s32 srcY, s32 w, s32 h, s32 dstX, s32 dstY) {
+    if (!m_LinearSurface || !m_Target || m_TargetLinear) return;
+    
+    // 目标区域裁剪到裁剪区域（已在屏幕内）
+    s32 x0 = dstX, y0 = dstY, x1 = dstX + w, y1 = dstY + h;
+    ClipToCurrent(x0, y0, x1, y1);
+    
+    // 源区域也必须在线性表面内
+    if (x0 < dstX - srcX) x0 = dstX - srcX;
+    if (y0 < dstY - srcY) y0 = dstY - srcY;
+    if (x1 > dstX - srcX + (s32)m_Width) x1 = dstX - srcX + m_Width;
+    if (y1 > dstY - srcY + (s32)m_Height) y1 = dstY - srcY + m_Height;
+    if (x0 >= x1 || y0 >= y1) return;
+    
+    for (s32 y = y0; y < y1; y++) {
+        s32 ly = y % 8;
+        u32 rowOffset = (ly / 2) * 32 + (ly % 2) * 8;
+        const u16* in = m_LinearSurface + (u32)(y - dstY + srcY) * m_Width + (srcX - dstX);
+        
+        s32 x = x0;
+        while (x < x1) {
+            s32 segEnd = (x & ~7) + 8;
+            if (segEnd > x1) segEnd = x1;
+            
+            s32 seg = (x % 32) / 8;
+            u16* out = m_Target + GetGobOffset(x / 32, y / 8) + rowOffset + (seg / 2) * 128 + (seg % 2) * 16;
+            
+            if ((x & 7) == 0 && segEnd - x == 8) {
+#if defined(__ARM_NEON)
+                vst1q_u16(out, vld1q_u16(in + x));
+#else
+                memcpy(out, in + x, 16);
+#endif
+            } else {
+                for (s32 i = x; i < segEnd; i++) out[i & 7] = in[i];
+            }
+            x = segEnd;
+        }
+    }
+}
+
 // 直接设置像素（不混合）
+// 单像素接口保留逐点检查，批量绘制的原语先整体裁剪，内层循环不再检查
 void GraphicsRenderer::SetPixel(s32 x, s32 y, Color color) {
-    if (x < 0 || y < 0 || x >= (s32)m_Width || y >= (s32)m_Height || m_CurrentFramebuffer == nullptr) return;
-    if (!IsInScissor(x, y)) return;  // 裁剪检查
+    if (!InClip(x, y) || m_Target == nullptr) return;
     u32 offset = GetPixelOffset(x, y);
-    ((u16*)m_CurrentFramebuffer)[offset] = ColorToU16(color);
+    m_Target[offset] = ColorToU16(color);
 }
 
 // 设置像素（与目标混合）（透明实现）
 void GraphicsRenderer::SetPixelBlend(s32 x, s32 y, Color color) {
-    if (x < 0 || y < 0 || x >= (s32)m_Width || y >= (s32)m_Height || m_CurrentFramebuffer == nullptr) return;
-    if (!IsInScissor(x, y)) return;  // 裁剪检查
+    if (!InClip(x, y) || m_Target == nullptr) return;
     u32 offset = GetPixelOffset(x, y);
-    Color src = ColorFromU16(((u16*)m_CurrentFramebuffer)[offset]);
-    Color dst = color;
-    Color out = {0, 0, 0, 0};
-    out.r = BlendColor(src.r, dst.r, dst.a);
-    out.g = BlendColor(src.g, dst.g, dst.a);
-    out.b = BlendColor(src.b, dst.b, dst.a);
-    // Alpha 叠加并限制到 0xF
-    u16 sumA = (u16)dst.a + (u16)src.a;
-    out.a = (sumA > 0xF) ? 0xF : (u8)sumA;
-    SetPixel(x, y, out);
+    // 定点混合，结果与按通道浮点混合一致；Alpha 叠加并限制到 0xF
+    m_Target[offset] = Blend4444(m_Target[offset], ColorToU16(color));
 }
 
 // 绘制矩形（混合模式）
 void GraphicsRenderer::DrawRect(s32 x, s32 y, s32 w, s32 h, Color color) {
     s32 x2 = x + w;
     s32 y2 = y + h;
-    if (x2 < 0 || y2 < 0) return;
-    if (x >= (s32)m_Width || y >= (s32)m_Height) return;
-    if (x < 0) x = 0;
-    if (y < 0) y = 0;
-    if (x2 > (s32)m_Width) x2 = m_Width;
-    if (y2 > (s32)m_Height) y2 = m_Height;
-    for (s32 xi = x; xi < x2; ++xi) {
-        for (s32 yi = y; yi < y2; ++yi) {
-            SetPixelBlend(xi, yi, color);
-        }
+    
+    // 整体裁剪，完全在裁剪区域外直接返回
+    if (!ClipToCurrent(x, y, x2, y2)) return;
+    
+    // 不透明颜色的混合结果就是颜色本身，直接按 GOB 整块写入
+    if (color.a == 0xF) {
+        FillSpanRect(x, y, x2, y2, ColorToU16(color));
+        return;
     }
+    
+    // 半透明：按行 / 8 像素段批量混合
+    BlendSpanRect(x, y, x2, y2, ColorToU16(color));
 }
 
 // 绘制圆角矩形
@@ -122,85 +360,142 @@ void GraphicsRenderer::DrawRoundedRect(s32 x, s32 y, s32 w, s32 h, s32 radius, C
     DrawRoundedRectPartial(x, y, w, h, radius, color, RoundedRectPart::ALL);
 }
 
-// 绘制部分圆角矩形（只有顶部或底部）
-void GraphicsRenderer::DrawRoundedRectPartial(s32 x, s32 y, s32 w, s32 h, s32 radius, Color color, RoundedRectPart part) {
-    // 先绘制主体矩形
-    DrawRect(x, y, w, h, color);
+// 圆角覆盖率表：角内像素 (cx, cy) 的覆盖率（0-15），cx / cy 从角的外侧数起
+// 每个像素 4x4 子采样，坐标放大 8 倍后全部用整数计算；半径不变时不重新计算
+void GraphicsRenderer::BuildCornerTable(s32 radius) {
+    if (radius == m_CornerRadius) return;
+    m_CornerRadius = radius;
     
-    // 根据 part 决定处理哪些角
-    bool processTopLeft = (part == RoundedRectPart::ALL || part == RoundedRectPart::TOP);
-    bool processTopRight = (part == RoundedRectPart::ALL || part == RoundedRectPart::TOP);
-    bool processBottomLeft = (part == RoundedRectPart::ALL || part == RoundedRectPart::BOTTOM);
-    bool processBottomRight = (part == RoundedRectPart::ALL || part == RoundedRectPart::BOTTOM);
+    s32 center = radius * 8;
+    s32 radiusSq = center * center;
     
-    // 在四个角绘制透明遮罩，实现圆角效果
     for (s32 cy = 0; cy < radius; cy++) {
         for (s32 cx = 0; cx < radius; cx++) {
-            float radiusSq = radius * radius;
-            
-            // 左上角
-            if (processTopLeft) {
-                float dx_tl = cx - radius + 0.5f;
-                float dy_tl = cy - radius + 0.5f;
-                float dist_tl = dx_tl * dx_tl + dy_tl * dy_tl;
-                if (dist_tl > radiusSq)
-                    SetPixel(x + cx, y + cy, {0, 0, 0, 0});
-            }
-            
-            // 右上角
-            if (processTopRight) {
-                float dx_tr = cx + 0.5f;
-                float dy_tr = cy - radius + 0.5f;
-                float dist_tr = dx_tr * dx_tr + dy_tr * dy_tr;
-                if (dist_tr > radiusSq)
-                    SetPixel(x + w - radius + cx, y + cy, {0, 0, 0, 0});
-            }
-            
-            // 左下角
-            if (processBottomLeft) {
-                float dx_bl = cx - radius + 0.5f;
-                float dy_bl = cy + 0.5f;
-                float dist_bl = dx_bl * dx_bl + dy_bl * dy_bl;
-                if (dist_bl > radiusSq)
-                    SetPixel(x + cx, y + h - radius + cy, {0, 0, 0, 0});
+            s32 count = 0;
+            for (s32 j = 0; j < 4; j++) {
+                s32 dy = center - (cy * 8 + j * 2 + 1);
+                for (s32 i = 0; i < 4; i++) {
+                    s32 dx = center - (cx * 8 + i * 2 + 1);
+                    if (dx * dx + dy * dy <= radiusSq) count++;
+                }
             }
+            m_CornerCoverage[cy][cx] = (u8)((count * 15 + 8) / 16);
+        }
+        
+        // 从该列起到角的内侧全部完全覆盖（同一行内覆盖率向内单调不减）
+        s32 solid = radius;
+        while (solid > 0 && m_CornerCoverage[cy][solid - 1] == 0xF) solid--;
+        m_CornerSolid[cy] = (u8)solid;
+    }
+}
+
+// 按覆盖率混合一个边缘像素：目标为全透明时直接写入（避免与透明黑混合产生暗边）
+void GraphicsRenderer::BlendCoverage(s32 x, s32 y, u16 raw, u8 coverage) {
+    u32 a = Div15((raw >> 12) * coverage);
+    if (a == 0) return;
+    
+    u16 fg = (u16)((raw & 0x0FFF) | (a << 12));
+    u16* pixel = m_Target + GetPixelOffset(x, y);
+    *pixel = ((*pixel >> 12) == 0) ? fg : Blend4444(*pixel, fg);
+}
+
+// 绘制部分圆角矩形（只有顶部或底部）
+// 逐行光栅化：每行左右圆角的边缘像素按覆盖率混合，中间部分作为一个整段写入，每个像素只写一次
+// 圆角外的像素不绘制（不再先画整个矩形再挖空）
+void GraphicsRenderer::DrawRoundedRectPartial(s32 x, s32 y, s32 w, s32 h, s32 radius, Color color, RoundedRectPart part) {
+    if (w <= 0 || h <= 0 || !m_Target) return;
+    
+    bool roundTop = (part == RoundedRectPart::ALL || part == RoundedRectPart::TOP);
+    bool roundBottom = (part == RoundedRectPart::ALL || part == RoundedRectPart::BOTTOM);
+    
+    // 左右圆角不重叠；高度小于半径时（如高光条）圆角只取靠近边的几行
+    if (radius > w / 2) radius = w / 2;
+    if (radius > CORNER_MAX_RADIUS) radius = CORNER_MAX_RADIUS;
+    if (radius < 0) radius = 0;
+    BuildCornerTable(radius);
+    
+    // 整体裁剪：只遍历可见的行，完全不可见直接返回
+    s32 clipX0 = x, clipY0 = y, clipX1 = x + w, clipY1 = y + h;
+    if (!ClipToCurrent(clipX0, clipY0, clipX1, clipY1)) return;
+    
+    u16 raw = ColorToU16(color);
+    bool opaque = (color.a == 0xF);
+    
+    for (s32 row = clipY0 - y; row < clipY1 - y; row++) {
+        s32 py = y + row;
+        
+        // 该行在上 / 下圆角中的行号（不在圆角内为 -1），同时在两者内时取覆盖率较小的
+        s32 top = (roundTop && row < radius) ? row : -1;
+        s32 bottom = (roundBottom && h - 1 - row < radius) ? h - 1 - row : -1;
+        
+        s32 solid = 0;
+        if (top >= 0) solid = m_CornerSolid[top];
+        if (bottom >= 0 && m_CornerSolid[bottom] > solid) solid = m_CornerSolid[bottom];
+        
+        // 边缘像素（左右对称）
+        for (s32 cx = 0; cx < solid; cx++) {
+            u8 coverage = 0xF;
+            if (top >= 0 && m_CornerCoverage[top][cx] < coverage) coverage = m_CornerCoverage[top][cx];
+            if (bottom >= 0 && m_CornerCoverage[bottom][cx] < coverage) coverage = m_CornerCoverage[bottom][cx];
+            if (coverage == 0) continue;
             
-            // 右下角
-            if (processBottomRight) {
-                float dx_br = cx + 0.5f;
-                float dy_br = cy + 0.5f;
-                float dist_br = dx_br * dx_br + dy_br * dy_br;
-                if (dist_br > radiusSq)
-                    SetPixel(x + w - radius + cx, y + h - radius + cy, {0, 0, 0, 0});
-            }
+            s32 left = x + cx;
+            s32 right = x + w - 1 - cx;
+            if (left >= clipX0 && left < clipX1) BlendCoverage(left, py, raw, coverage);
+            if (right >= clipX0 && right < clipX1) BlendCoverage(right, py, raw, coverage);
         }
+        
+        // 中间完全覆盖的部分：一个整段
+        s32 x0 = x + solid, x1 = x + w - solid;
+        if (x0 < clipX0) x0 = clipX0;
+        if (x1 > clipX1) x1 = clipX1;
+        if (x0 >= x1) continue;
+        
+        if (opaque) FillSpanRect(x0, py, x1, py + 1, raw);
+        else BlendSpanRect(x0, py, x1, py + 1, raw);
     }
 }
 
 // 填充整个屏幕
 void GraphicsRenderer::FillScreen(Color color) {
-    // 使用 SetPixel 逐像素填充（处理块线性布局）
-    if (!m_CurrentFramebuffer) return;
+    // 按 GOB 顺序整块填充（处理块线性布局）
+    if (!m_Target) return;
     
-    for (s32 y = 0; y < (s32)m_Height; y++) {
-        for (s32 x = 0; x < (s32)m_Width; x++) {
-            SetPixel(x, y, color);
-        }
+    FillSpanRect(m_Clip.x0, m_Clip.y0, m_Clip.x1, m_Clip.y1, ColorToU16(color));
+}
+
+// 压入裁剪区域：新区域为当前区域与 (x, y, w, h) 的交集
+// 超出栈深度时无法保存当前区域，不改变裁剪区域，只计数让对应的 PopClip 什么都不做
+void GraphicsRenderer::PushClip(s32 x, s32 y, s32 w, s32 h) {
+    if (m_ClipDepth >= CLIP_STACK_DEPTH) {
+        m_ClipDepth++;
+        return;
     }
+    m_ClipStack[m_ClipDepth++] = m_Clip;
+    
+    s32 x1 = x + w, y1 = y + h;
+    if (!ClipToCurrent(x, y, x1, y1)) {
+        // 交集为空：之后的绘制全部跳过
+        x1 = x;
+        y1 = y;
+    }
+    m_Clip = {x, y, x1, y1};
 }
 
-// 启用裁剪区域
-void GraphicsRenderer::EnableScissoring(s32 x, s32 y, s32 w, s32 h) {
-    m_ScissorEnabled = true;
-    m_ScissorX = x;
-    m_ScissorY = y;
-    m_ScissorW = w;
-    m_ScissorH = h;
+// 弹出裁剪区域，恢复压入前的区域
+void GraphicsRenderer::PopClip() {
+    if (m_ClipDepth == 0) return;
+    m_ClipDepth--;
+    if (m_ClipDepth < CLIP_STACK_DEPTH) m_Clip = m_ClipStack[m_ClipDepth];
 }
 
-// 禁用裁剪区域
-void GraphicsRenderer::DisableScissoring() {
-    m_ScissorEnabled = false;
+// 将 [x0, x1) x [y0, y1) 裁剪到当前裁剪区域，返回是否非空
+bool GraphicsRenderer::ClipToCurrent(s32& x0, s32& y0, s32& x1, s32& y1) const {
+    if (x0 < m_Clip.x0) x0 = m_Clip.x0;
+    if (y0 < m_Clip.y0) y0 = m_Clip.y0;
+    if (x1 > m_Clip.x1) x1 = m_Clip.x1;
+    if (y1 > m_Clip.y1) y1 = m_Clip.y1;
+    return x0 < x1 && y0 < y1;
 }
 
 // UTF-8 解码：将 UTF-8 字符串解析为 Unicode 码点
@@ -217,7 +512,23 @@ const char* GraphicsRenderer::Utf8Next(const char* s, u32* out_cp) {
 
 // 文本渲染：在矩形区域内，垂直居中，水平可选对齐
 void GraphicsRenderer::DrawText(const char* text, s32 x, s32 y, s32 w, s32 h, float fontSize, Color color, TextAlign align) {
-    if (!text || !m_CurrentFramebuffer) return;
+    if (!text || !m_Target) return;
+    
+    TextLayout layout;
+    LayoutText(layout, text, x, y, w, h, fontSize, align);
+    DrawTextLayout(layout, 0, 0, color);
+}
+
+// 文本排版：解码 UTF-8、解析字形、计算笔位置和基线
+void GraphicsRenderer::LayoutText(TextLayout& layout, const char* text, s32 x, s32 y, s32 w, s32 h, float fontSize, TextAlign align) {
+    layout.x = x;
+    layout.y = y;
+    layout.w = w;
+    layout.h = h;
+    layout.fontSize = fontSize;
+    layout.count = 0;
+    FreeTextMask(layout);
+    if (!text) return;
     
     FontManager& fontMgr = FontManager::Instance();
     stbtt_fontinfo* font = fontMgr.GetStdFont();
@@ -240,74 +551,207 @@ void GraphicsRenderer::DrawText(const char* text, s32 x, s32 y, s32 w, s32 h, fl
             break;
     }
     
-    // 计算垂直居中位置（考虑字体的实际度量）
-    int ascent, descent, lineGap;
-    stbtt_GetFontVMetrics(font, &ascent, &descent, &lineGap);
-    
-    // 使用与 RenderGlyph 相同的缩放方式
-    float scale = fontMgr.CalculateScaleForVisibleHeight(font, fontSize);
-    
-    // 实际的 ascent 和 descent（像素，descent 是负值）
-    float actualAscent = ascent * scale;
-    float actualDescent = descent * scale;  // 保持负值
+    // 计算垂直居中位置（考虑字体的实际度量，与 RenderGlyph 相同的缩放方式）
+    // ascent 和 descent 已换算为像素，descent 是负值
+    FontManager::FontMetrics metrics = fontMgr.GetFontMetrics(font, fontSize);
     
     // 字体的视觉中心距离基线的偏移（向上为正）
-    float visualCenterOffset = (actualAscent + actualDescent) / 2.0f;
+    float visualCenterOffset = (metrics.ascent + metrics.descent) / 2.0f;
     
     // 基线位置 = 面板中心 + 视觉中心偏移
-    s32 startY = y + h / 2 + (s32)visualCenterOffset;
+    layout.baselineY = y + h / 2 + (s32)visualCenterOffset;
     
     s32 cursorX = startX;
-    s32 cursorY = startY;
     
-    // 逐字符解析和渲染
-    while (*text) {
+    // 逐字符解析和定位
+    while (*text && layout.count < TEXT_LAYOUT_MAX_GLYPHS) {
         u32 codepoint;
         text = Utf8Next(text, &codepoint);
         if (codepoint == 0) break;
         
-        // 使用 FontManager 渲染字形
-        auto glyph = fontMgr.RenderGlyph(codepoint, fontSize);
+        FontManager::ResolvedGlyph resolved = fontMgr.ResolveGlyph(codepoint);
+        TextLayout::Glyph& g = layout.glyphs[layout.count++];
+        g.font = resolved.font;
+        g.glyphIndex = resolved.glyphIndex;
+        g.penX = cursorX;
         
-        // 如果有位图数据，绘制字形
-        if (glyph.data) {
-            // 绘制位图到屏幕（带抗锯齿 + 边界裁剪）
-            for (int by = 0; by < glyph.height; by++) {
-                for (int bx = 0; bx < glyph.width; bx++) {
-                    // 计算像素位置
-                    s32 px = cursorX + bx + glyph.xoffset;
-                    s32 py = cursorY + by + glyph.yoffset;
-                    
-                    // 边界裁剪：超出矩形区域的像素不渲染
-                    if (px < x || px >= x + w || py < y || py >= y + h) {
-                        continue;
-                    }
-                    
-                    // 获取灰度值（0-255）
-                    u8 coverage = glyph.data[by * glyph.width + bx];
-                    if (coverage == 0) continue;  // 完全透明，跳过
-                    
-                    // 转换为 RGBA4444 的 alpha（0-15）
-                    u8 alpha = coverage / 17;  // 255 / 15 ≈ 17
-                    
-                    // 创建带抗锯齿的颜色
-                    Color textColor = color;
-                    textColor.a = (alpha * color.a) / 15;  // 混合原始透明度
-                    
-                    // 绘制像素
-                    SetPixelBlend(px, py, textColor);
-                }
+        // 移动光标到下一个字符位置（无论是否有位图数据，都要前进）
+        // 空格字符不添加额外间距（空格本身就是间距）
+        s32 spacing = (codepoint == ' ') ? 0 : (s32)(3.0f);
+        cursorX += fontMgr.GetGlyphAdvance(codepoint, fontSize) + spacing;
+    }
+}
+
+// 字形覆盖率查找表：与逐像素计算相同，alpha = (coverage / 17) * color.a / 15
+void GraphicsRenderer::BuildGlyphLut(u16 raw) {
+    if (raw == m_GlyphLutColor) return;
+    m_GlyphLutColor = raw;
+    
+    u32 rgb = raw & 0x0FFF;
+    u32 colorA = raw >> 12;
+    for (u32 coverage = 0; coverage < 256; coverage++) {
+        u32 a = (coverage / 17) * colorA / 15;
+        m_GlyphLut[coverage] = a ? (u16)(rgb | (a << 12)) : 0;
+    }
+}
+
+// 覆盖率位图混合：每行先跳过 alpha 为 0 的像素，连续的不透明段经查找表展开后整段混合
+void GraphicsRenderer::BlitCoverage(const u8* src, s32 stride, s32 x0, s32 y0, s32 x1, s32 y1) {
+    u16 span[64];
+    
+    for (s32 y = y0; y < y1; y++, src += stride) {
+        s32 x = x0;
+        while (x < x1) {
+            // 跳过透明段（覆盖率为 0 的部分每次检查 8 字节）
+            while (x + 8 <= x1) {
+                u64 word;
+                memcpy(&word, src + (x - x0), sizeof(word));
+                if (word != 0) break;
+                x += 8;
             }
+            while (x < x1 && m_GlyphLut[src[x - x0]] == 0) x++;
             
-            // 释放字形位图
-            fontMgr.FreeGlyph(glyph);
+            // 展开不透明段（一次最多 64 像素）
+            s32 start = x;
+            s32 n = 0;
+            while (x < x1 && n < 64) {
+                u16 fg = m_GlyphLut[src[x - x0]];
+                if (fg == 0) break;
+                span[n++] = fg;
+                x++;
+            }
+            if (n > 0) BlendSpanRow(start, y, span, n);
+        }
+    }
+}
+
+// 绘制排版结果
+void GraphicsRenderer::DrawTextLayout(const TextLayout& layout, s32 dx, s32 dy, Color color) {
+    if (!m_Target) return;
+    
+    FontManager& fontMgr = FontManager::Instance();
+    
+    // 文本框（平移后）与裁剪区域的交集，超出部分不绘制
+    s32 boxX0 = layout.x + dx;
+    s32 boxY0 = layout.y + dy;
+    s32 boxX1 = boxX0 + layout.w;
+    s32 boxY1 = boxY0 + layout.h;
+    if (!ClipToCurrent(boxX0, boxY0, boxX1, boxY1)) return;
+    
+    BuildGlyphLut(ColorToU16(color));
+    
+    // 有遮罩时一次混合整段文本（遮罩已在文本框内，只需裁剪到当前区域）
+    if (layout.mask) {
+        s32 maskX = layout.maskX + dx;
+        s32 maskY = layout.maskY + dy;
+        s32 x0 = maskX, y0 = maskY, x1 = maskX + layout.maskW, y1 = maskY + layout.maskH;
+        if (ClipToCurrent(x0, y0, x1, y1)) {
+            BlitCoverage(layout.mask + (y0 - maskY) * layout.maskW + (x0 - maskX), layout.maskW, x0, y0, x1, y1);
         }
+        return;
+    }
+    
+    s32 cursorY = layout.baselineY + dy;
+    for (u32 i = 0; i < layout.count; i++) {
+        const TextLayout::Glyph& g = layout.glyphs[i];
+        s32 cursorX = g.penX + dx;
         
-        // 移动光标到下一个字符位置（无论是否有位图数据，都要前进）
-        // 空格字符不添加额外间距（空格本身就是间距）
-        s32 spacing = (codepoint == ' ') ? 0 : (s32)(3.0f);
-        cursorX += glyph.advance + spacing; 
+        // 使用 FontManager 渲染字形
+        auto glyph = fontMgr.RenderGlyph(g.font, g.glyphIndex, layout.fontSize);
+        if (!glyph.data) continue;
+        
+        // 字形框整体裁剪到文本框，内层循环不再逐像素检查
+        s32 glyphX = cursorX + glyph.xoffset;
+        s32 glyphY = cursorY + glyph.yoffset;
+        s32 x0 = glyphX, y0 = glyphY, x1 = glyphX + glyph.width, y1 = glyphY + glyph.height;
+        if (x0 < boxX0) x0 = boxX0;
+        if (y0 < boxY0) y0 = boxY0;
+        if (x1 > boxX1) x1 = boxX1;
+        if (y1 > boxY1) y1 = boxY1;
+        
+        // 绘制位图到屏幕（带抗锯齿）
+        if (x0 < x1 && y0 < y1) {
+            BlitCoverage(glyph.data + (y0 - glyphY) * glyph.width + (x0 - glyphX), glyph.width, x0, y0, x1, y1);
+        }
+        
+        // 释放字形位图
+        fontMgr.FreeGlyph(glyph);
+    }
+}
+
+// 文本遮罩：先求所有字形外框（裁剪到文本框）的并集，再把覆盖率饱和累加进去
+// 字形不重叠时混合结果与逐字形绘制相同；重叠处按覆盖率之和混合一次
+bool GraphicsRenderer::BuildTextMask(TextLayout& layout) {
+    FreeTextMask(layout);
+    
+    FontManager& fontMgr = FontManager::Instance();
+    s32 boxX0 = layout.x, boxY0 = layout.y;
+    s32 boxX1 = layout.x + layout.w, boxY1 = layout.y + layout.h;
+    
+    // 1. 遮罩范围（只取字形外框，不光栅化）
+    s32 maskX0 = boxX1, maskY0 = boxY1, maskX1 = boxX0, maskY1 = boxY0;
+    for (u32 i = 0; i < layout.count; i++) {
+        const TextLayout::Glyph& g = layout.glyphs[i];
+        int gx0, gy0, gx1, gy1;
+        fontMgr.GetGlyphBox(g.font, g.glyphIndex, layout.fontSize, &gx0, &gy0, &gx1, &gy1);
+        
+        s32 x0 = g.penX + gx0, y0 = layout.baselineY + gy0;
+        s32 x1 = g.penX + gx1, y1 = layout.baselineY + gy1;
+        if (x0 < boxX0) x0 = boxX0;
+        if (y0 < boxY0) y0 = boxY0;
+        if (x1 > boxX1) x1 = boxX1;
+        if (y1 > boxY1) y1 = boxY1;
+        if (x0 < x1 && y0 < y1) {
+            if (x0 < maskX0) maskX0 = x0;
+            if (y0 < maskY0) maskY0 = y0;
+            if (x1 > maskX1) maskX1 = x1;
+            if (y1 > maskY1) maskY1 = y1;
+        }
+    }
+    if (maskX0 >= maskX1 || maskY0 >= maskY1) return false;
+    
+    s32 maskW = maskX1 - maskX0;
+    s32 maskH = maskY1 - maskY0;
+    u8* mask = (u8*)calloc((size_t)maskW * maskH, 1);
+    if (!mask) return false;
+    
+    // 2. 累加每个字形的覆盖率
+    for (u32 i = 0; i < layout.count; i++) {
+        const TextLayout::Glyph& g = layout.glyphs[i];
+        auto glyph = fontMgr.RenderGlyph(g.font, g.glyphIndex, layout.fontSize);
+        if (!glyph.data) continue;
+        
+        s32 glyphX = g.penX + glyph.xoffset;
+        s32 glyphY = layout.baselineY + glyph.yoffset;
+        s32 x0 = glyphX, y0 = glyphY, x1 = glyphX + glyph.width, y1 = glyphY + glyph.height;
+        if (x0 < maskX0) x0 = maskX0;
+        if (y0 < maskY0) y0 = maskY0;
+        if (x1 > maskX1) x1 = maskX1;
+        if (y1 > maskY1) y1 = maskY1;
+        
+        for (s32 py = y0; py < y1; py++) {
+            const u8* src = glyph.data + (py - glyphY) * glyph.width + (x0 - glyphX);
+            u8* dst = mask + (py - maskY0) * maskW + (x0 - maskX0);
+            for (s32 n = x1 - x0; n > 0; n--, src++, dst++) {
+                u32 sum = *dst + *src;
+                *dst = (sum > 255) ? 255 : (u8)sum;
+            }
+        }
+        fontMgr.FreeGlyph(glyph);
     }
+    
+    layout.mask = mask;
+    layout.maskX = maskX0;
+    layout.maskY = maskY0;
+    layout.maskW = maskW;
+    layout.maskH = maskH;
+    return true;
+}
+
+// 释放文本遮罩
+void GraphicsRenderer::FreeTextMask(TextLayout& layout) {
+    free(layout.mask);
+    layout.mask = nullptr;
 }
 
 // 测量文本宽度
@@ -323,18 +767,10 @@ float GraphicsRenderer::MeasureTextWidth(const char* text, float fontSize) {
         text = Utf8Next(text, &codepoint);
         if (codepoint == 0) break;
         
-        // 获取字形信息
-        auto glyph = fontMgr.RenderGlyph(codepoint, fontSize);
-        
-        // 无论是否有位图数据，都要累加 advance（空格也占宽度）
+        // 只读取水平度量，不光栅化（空格也占宽度）
         // 空格字符不添加额外间距（空格本身就是间距）
         s32 spacing = (codepoint == ' ') ? 0 : (s32)(3.0f);
-        totalWidth += glyph.advance + spacing;
-        
-        // 如果有位图数据，释放它
-        if (glyph.data) {
-            fontMgr.FreeGlyph(glyph);
-        }
+        totalWidth += fontMgr.GetGlyphAdvance(codepoint, fontSize) + spacing;
     }
     
     return totalWidth;
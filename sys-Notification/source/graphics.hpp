@@ -2,11 +2,48 @@
 
 #include <switch.h>
 
+struct stbtt_fontinfo;
+
 // RGBA4444 颜色结构（每个分量 0-15）
 struct Color {
     u8 r, g, b, a;
 };
 
+// 裁剪区域栈深度
+#define CLIP_STACK_DEPTH 4
+
+// 圆角矩形支持的最大圆角半径（覆盖率表大小，更大的半径按此截断）
+#define CORNER_MAX_RADIUS 16
+
+// 单段文本最多排版的字形数（通知文本最长 31 字节）
+#define TEXT_LAYOUT_MAX_GLYPHS 32
+
+// 文本排版结果：解码、字体解析、定位只做一次，之后每次绘制直接重放
+// 坐标相对排版时的原点，绘制时可整体平移
+// 可选的覆盖率遮罩由 BuildTextMask 生成（malloc，重新排版或 FreeTextMask 时释放）
+struct TextLayout {
+    struct Glyph {
+        stbtt_fontinfo* font;   // 已解析的字体
+        int glyphIndex;         // 字体内的字形索引
+        s32 penX;               // 笔位置（基线上的 X）
+    };
+    
+    s32 x, y, w, h;             // 文本框（超出部分不绘制）
+    float fontSize;             // 字号
+    s32 baselineY;              // 基线 Y
+    u32 count;                  // 字形数量
+    Glyph glyphs[TEXT_LAYOUT_MAX_GLYPHS];
+    
+    // 整段文本的 8 位覆盖率遮罩（行主序，范围为字形外框与文本框的交集）
+    u8* mask = nullptr;
+    s32 maskX, maskY, maskW, maskH;
+    
+    // 遮罩由 FreeTextMask 释放，复制后两份会指向同一块内存
+    TextLayout() = default;
+    TextLayout(const TextLayout&) = delete;
+    TextLayout& operator=(const TextLayout&) = delete;
+};
+
 // 图形渲染器：封装所有底层绘制操作
 class GraphicsRenderer {
 public:
@@ -16,10 +53,26 @@ public:
     // 绑定到 Framebuffer（在 VI/Layer 初始化后调用）
     void Bind(Framebuffer* fb, Event* vsyncEvent, u16 width, u16 height);
     
+    // 绑定线性合成表面（width x height 个 u16，行主序；不拥有，传 nullptr 解绑）
+    void BindLinearSurface(u16* pixels);
+    
     // 帧管理
     void StartFrame();
     void EndFrame();
     
+    // 离屏绘制：不获取帧缓冲，直接绘制到线性表面（需已绑定线性表面）
+    void StartOffscreen();
+    void EndOffscreen();
+    
+    // 将线性表面中 (srcX, srcY, w, h) 区域拷贝到当前帧的 (dstX, dstY)
+    // 仅在直接绘制帧缓冲的帧内有效，受屏幕边界和裁剪区域限制
+    void BlitLinear(s32 srcX, s32 srcY, s32 w, s32 h, s32 dstX, s32 dstY);
+    
+    // 线性合成模式（需已绑定线性表面，从下一次 StartFrame 起生效）
+    // 启用后绘制写入线性表面，EndFrame 时一次性转换为块线性写入帧缓冲
+    void EnableLinearComposition();
+    void DisableLinearComposition();
+    
     // 圆角矩形的部分区域
     enum class RoundedRectPart {
         ALL,     // 全部（默认）
@@ -48,12 +101,27 @@ public:
     // align: 水平对齐方式（默认居中）
     void DrawText(const char* text, s32 x, s32 y, s32 w, s32 h, float fontSize, Color color, TextAlign align = TextAlign::CENTER);
     
+    // 文本排版（参数与 DrawText 相同），结果可重复绘制
+    void LayoutText(TextLayout& layout, const char* text, s32 x, s32 y, s32 w, s32 h, float fontSize, TextAlign align = TextAlign::CENTER);
+    
+    // 绘制排版结果，整体平移 (dx, dy)；有遮罩时一次混合整张遮罩，否则逐字形绘制
+    void DrawTextLayout(const TextLayout& layout, s32 dx, s32 dy, Color color);
+    
+    // 将排版结果的所有字形累加到一张覆盖率遮罩，之后每次绘制不再逐字形光栅化和混合
+    // 内存不足或没有可见字形时返回 false，DrawTextLayout 照常逐字形绘制
+    bool BuildTextMask(TextLayout& layout);
+    
+    // 释放排版结果的覆盖率遮罩
+    static void FreeTextMask(TextLayout& layout);
+    
     // 文本测量
     float MeasureTextWidth(const char* text, float fontSize);
     
-    // 裁剪区域（Scissoring）
-    void EnableScissoring(s32 x, s32 y, s32 w, s32 h);
-    void DisableScissoring();
+    // 裁剪区域栈：之后的绘制只影响当前区域（初始为整个屏幕）
+    // PushClip 与当前区域求交，PopClip 恢复；原语先整体裁剪再绘制，不逐像素检查
+    // 超过 CLIP_STACK_DEPTH 层的 PushClip 被忽略（仍与 PopClip 配对）
+    void PushClip(s32 x, s32 y, s32 w, s32 h);
+    void PopClip();
     
     // 颜色工具（静态，可以独立使用）
     static inline u16 ColorToU16(Color c);
@@ -67,22 +135,68 @@ private:
     u16 m_Width;
     u16 m_Height;
     
-    // 裁剪区域状态
-    bool m_ScissorEnabled;
-    s32 m_ScissorX, m_ScissorY, m_ScissorW, m_ScissorH;
+    // 绘制目标（块线性帧缓冲或线性表面）
+    u16* m_LinearSurface;
+    u16* m_Target;
+    bool m_TargetLinear;
+    bool m_LinearComposition;
+    
+    // 裁剪区域 [x0, x1) x [y0, y1)，始终在屏幕内
+    struct ClipRect {
+        s32 x0, y0, x1, y1;
+    };
+    ClipRect m_Clip;                            // 当前裁剪区域
+    ClipRect m_ClipStack[CLIP_STACK_DEPTH];     // 压入前的区域
+    u32 m_ClipDepth;                            // 栈深度
+    
+    // 圆角覆盖率表（按半径缓存）
+    s32 m_CornerRadius;                                            // 表对应的半径（-1 为未计算）
+    u8 m_CornerCoverage[CORNER_MAX_RADIUS][CORNER_MAX_RADIUS];     // 角内像素覆盖率（0-15）
+    u8 m_CornerSolid[CORNER_MAX_RADIUS];                           // 每行从该列起完全覆盖
+    
+    // 字形覆盖率查找表（按颜色缓存）：覆盖率 0-255 -> 待混合的 RGBA4444 像素，alpha 为 0 的项为 0
+    u32 m_GlyphLutColor;        // 表对应的颜色（超出 u16 范围表示未计算）
+    u16 m_GlyphLut[256];
     
     // 块线性地址计算
     u32 GetPixelOffset(s32 x, s32 y);
     
-    // 检查坐标是否在裁剪区域内
-    inline bool IsInScissor(s32 x, s32 y) const {
-        if (!m_ScissorEnabled) return true;
-        return x >= m_ScissorX && x < m_ScissorX + m_ScissorW &&
-               y >= m_ScissorY && y < m_ScissorY + m_ScissorH;
+    // 块线性 GOB（64 字节 x 8 行，32x8 像素）起始偏移（以 u16 为单位）
+    u32 GetGobOffset(s32 gobX, s32 gobY);
+    
+    // 按 GOB 顺序填充矩形 [x0, x1) x [y0, y1)（调用者负责裁剪到屏幕内）
+    // 整块 GOB 用 512 字节连续写入，整行 8 像素用 16 字节写入，边缘才逐像素写
+    void FillSpanRect(s32 x0, s32 y0, s32 x1, s32 y1, u16 raw);
+    
+    // 按 GOB 顺序将 raw 混合到矩形 [x0, x1) x [y0, y1)（调用者负责裁剪），结果与逐像素 SetPixelBlend 相同
+    void BlendSpanRect(s32 x0, s32 y0, s32 x1, s32 y1, u16 raw);
+    
+    // 计算半径为 radius 的圆角覆盖率表（半径不变时直接返回）
+    void BuildCornerTable(s32 radius);
+    
+    // 将 raw 按覆盖率 coverage（0-15）混合到 (x, y)（调用者负责裁剪）
+    void BlendCoverage(s32 x, s32 y, u16 raw, u8 coverage);
+    
+    // 将一行 count 个像素 fg 混合到 (x, y) 起（调用者负责裁剪），块线性目标按 8 像素段拆分
+    void BlendSpanRow(s32 x, s32 y, const u16* fg, s32 count);
+    
+    // 计算颜色 raw 的字形覆盖率查找表（颜色不变时直接返回）
+    void BuildGlyphLut(u16 raw);
+    
+    // 将覆盖率位图（字形或文本遮罩）的 [x0, x1) x [y0, y1) 部分按查找表混合到屏幕（调用者负责裁剪）
+    // src 指向 (x0, y0) 对应的覆盖率，stride 为位图宽度；跳过透明段，其余按行批量混合
+    void BlitCoverage(const u8* src, s32 stride, s32 x0, s32 y0, s32 x1, s32 y1);
+    
+    // 将线性表面整体转换为块线性写入帧缓冲（每行 32 像素一组，4 次 16 字节拷贝）
+    void SwizzleBlit(u16* dst, const u16* src);
+    
+    // 检查坐标是否在当前裁剪区域内（只用于单像素接口）
+    inline bool InClip(s32 x, s32 y) const {
+        return x >= m_Clip.x0 && x < m_Clip.x1 && y >= m_Clip.y0 && y < m_Clip.y1;
     }
     
-    // 颜色混合
-    static inline u8 BlendColor(u8 src, u8 dst, u8 alpha);
+    // 将 [x0, x1) x [y0, y1) 裁剪到当前裁剪区域，返回是否非空
+    bool ClipToCurrent(s32& x0, s32& y0, s32& x1, s32& y1) const;
     
     // UTF-8 解码
     static const char* Utf8Next(const char* s, u32* out_cp);
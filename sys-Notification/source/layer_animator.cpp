@@ -0,0 +1,38 @@
+#include "layer_animator.hpp"
+
+// 缓动函数：快进慢出（EaseOutCubic）
+float LayerAnimator::EaseOutCubic(float t) {
+    float f = t - 1.0f;
+    return f * f * f + 1.0f;
+}
+
+// 根据起始时间计算当前进度
+float LayerAnimator::Progress(uint64_t startNs, uint32_t durationMs, bool* done) {
+    uint64_t elapsedMs = (m_Control.GetTimeNs() - startNs) / 1'000'000ULL;
+    float t = (durationMs > 0) ? (float)elapsedMs / durationMs : 1.0f;
+    if (t > 1.0f) t = 1.0f;
+    *done = (t >= 1.0f);
+    return EaseOutCubic(t);
+}
+
+// 将图层放到滑入起点
+uint32_t LayerAnimator::PrepareSlide(int32_t fromX, int32_t y) {
+    return m_Control.SetPosition(fromX, y);
+}
+
+// 水平滑入
+uint32_t LayerAnimator::Slide(int32_t fromX, int32_t toX, int32_t y, uint32_t durationMs) {
+    m_Control.WaitVsync();
+    
+    uint64_t startNs = m_Control.GetTimeNs();
+    bool done = false;
+    while (!done) {
+        float progress = Progress(startNs, durationMs, &done);
+        int32_t x = done ? toX : fromX + (int32_t)(progress * (toX - fromX));
+        
+        uint32_t rc = m_Control.SetPosition(x, y);
+        if (rc != 0) return rc;
+        m_Control.WaitVsync();
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// 图层控制接口：动画只通过它操作图层
+// 头文件不依赖 libnx，主机上可以替换为记录桩，验证每一帧的图层位置序列
+// 返回值与 libnx 的 Result 相同（0 为成功）
+class LayerControl {
+public:
+    virtual ~LayerControl() = default;
+    
+    virtual uint32_t SetPosition(float x, float y) = 0;
+    virtual void WaitVsync() = 0;          // 等待下一次垂直同步
+    virtual uint64_t GetTimeNs() = 0;      // 单调时间（纳秒）
+};
+
+// 图层动画：面板内容只绘制一次，由合成器移动图层完成滑入
+// 每个垂直同步更新一次图层位置，CPU 不再逐帧光栅化
+// 展开动画不在这里：缩放图层会把面板压扁，展开由裁剪区域逐帧绘制（NotificationManager::AnimateExpand）
+class LayerAnimator {
+public:
+    explicit LayerAnimator(LayerControl& control) : m_Control(control) {}
+    
+    // 将图层放到滑入起点（在绘制面板之前调用，避免面板在旧位置闪现一帧）
+    uint32_t PrepareSlide(int32_t fromX, int32_t y);
+    
+    // 水平滑入：图层 X 从 fromX 移动到 toX
+    uint32_t Slide(int32_t fromX, int32_t toX, int32_t y, uint32_t durationMs);
+    
+    // 缓动函数：快进慢出（EaseOutCubic）
+    static float EaseOutCubic(float t);
+    
+private:
+    LayerControl& m_Control;
+    
+    // 根据起始时间计算当前进度（0.0 - 1.0，已缓动）
+    float Progress(uint64_t startNs, uint32_t durationMs, bool* done);
+};
@@ -50,6 +50,12 @@ void __libnx_free(void* p) {
 */
 
 // 堆的大小
+// 先分配的大块：帧缓冲（双缓冲）、nv 传输内存（__nx_nv_transfermem_size）、线性表面（416×100×2 = 83 KB）
+// 之后加载的缓存合计约 42 KB：
+// - 字形缓存 ≤ 16 KB（GLYPH_CACHE_BUDGET）
+// - 面板缓存 ≤ 16 KB（PANEL_CACHE_BUDGET）
+// - 文本遮罩：图标和文本各一块，每像素 1 字节，单行文本约 10 KB（最大为排版框 416×100）
+// 调整缓存预算时需要一起检查这里的余量
 #define INNER_HEAP_SIZE 0x6B000          // 428 KB
 
 // 系统模块不应使用applet相关功能
@@ -1,4 +1,8 @@
 #include "notification.hpp"
+#include "vi_layer_control.hpp"
+#include "font_manager.hpp"
+#include "util/log.h"
+#include <cstdlib>
 #include <cstring>
 
 // 渲染和显示分离（利用硬件拉伸节省内存）
@@ -26,6 +30,20 @@
 
 #define PANEL_FONT_SIZE  28              // 字体大小（渲染尺寸）
 
+// 动画时长
+#define SLIDE_DURATION_MS   250          // 滑入时间
+#define EXPAND_DURATION_MS  400          // 展开时间
+
+// 动画后端：1 = 滑入时移动 VI 图层（合成器完成动画），0 = CPU 逐帧绘制；展开始终按裁剪区域逐帧绘制
+#define USE_LAYER_ANIMATION 1
+
+// 未预渲染面板时的帧合成方式：1 = 每帧先绘制到线性表面，EndFrame 时整体转换为块线性
+//                              0 = 面板预渲染到线性表面（并进入面板缓存），每帧只做拷贝
+#define USE_LINEAR_COMPOSITION 0
+
+// 面板样式版本：修改 DrawNotificationContent 的外观后递增，使已缓存的面板失效
+#define PANEL_STYLE_VERSION 2
+
 // libnx 内部全局变量：用于关联 ManagedLayer 和普通 Layer
 extern "C" u64 __nx_vi_layer_id;
 
@@ -40,16 +58,27 @@ Result NotificationManager::ViAddToLayerStack(ViLayer* layer, ViLayerStack stack
 
 // 构造函数：轻量级初始化，不涉及系统服务
 NotificationManager::NotificationManager() 
-    : m_FramebufferWidth(FB_WIDTH)    // 使用宏定义（自动对齐到 32 的倍数）
+    : m_LinearSurface(nullptr)
+    , m_LayoutKey{}
+    , m_LayoutValid(false)
+    , m_FramebufferWidth(FB_WIDTH)    // 使用宏定义（自动对齐到 32 的倍数）
     , m_FramebufferHeight(FB_HEIGHT)  // 使用宏定义
     , m_Initialized(false)
+    , m_PanelCached(false)
 {
 }
 
 // 析构函数：清理所有图形资源
 NotificationManager::~NotificationManager() {
+    GraphicsRenderer::FreeTextMask(m_IconLayout);
+    GraphicsRenderer::FreeTextMask(m_TextLayout);
+    
     if (!m_Initialized) return;
     
+    m_Renderer.BindLinearSurface(nullptr);
+    free(m_LinearSurface);
+    m_LinearSurface = nullptr;
+    
     framebufferClose(&m_Framebuffer);
     nwindowClose(&m_Window);
     viDestroyManagedLayer(&m_Layer);
@@ -144,7 +173,11 @@ Result NotificationManager::Init() {
     m_Renderer.Bind(&m_Framebuffer, &m_VsyncEvent, 
                     m_FramebufferWidth, m_FramebufferHeight);
     
-    // 17. 初始化完成
+    // 17. 分配线性合成表面（可选，失败时退回直接绘制块线性帧缓冲）
+    m_LinearSurface = (u16*)aligned_alloc(0x10, m_FramebufferWidth * m_FramebufferHeight * sizeof(u16));
+    m_Renderer.BindLinearSurface(m_LinearSurface);
+    
+    // 18. 初始化完成
     m_Initialized = true;
     return 0;
 
@@ -172,8 +205,29 @@ void NotificationManager::RestoreSystemInput() {
     hiddbgUnsetTouchScreenAutoPilotState();
 }
 
+// 排版图标和文本（面板原点为 0,0）
+void NotificationManager::LayoutPanel(const char* iconStr, const char* displayText) {
+    s32 panelW = PANEL_WIDTH;
+    s32 panelH = PANEL_HEIGHT;
+    
+    // 图标
+    s32 iconX = (s32)(15 * SCALE);
+    s32 iconW = (s32)(40 + 15 + 15) * SCALE;
+    s32 iconSize = (s32)(40 * SCALE);
+    m_Renderer.LayoutText(m_IconLayout, iconStr, iconX, 0, iconW, panelH, iconSize);
+    
+    // 文本
+    s32 textX = iconX + iconW + (s32)(3 * SCALE) + (s32)(3 * SCALE);
+    s32 textW = panelW - textX - (s32)(15 * SCALE);
+    m_Renderer.LayoutText(m_TextLayout, displayText, textX, 0, textW, panelH, PANEL_FONT_SIZE, GraphicsRenderer::TextAlign::LEFT);
+    
+    // 每段文本累加成一张遮罩，之后每帧只混合一次（分配失败时逐字形绘制）
+    m_Renderer.BuildTextMask(m_IconLayout);
+    m_Renderer.BuildTextMask(m_TextLayout);
+}
+
 // 绘制通知内容（不包含动画）
-void NotificationManager::DrawNotificationContent(s32 drawX, s32 drawY, const char* iconStr, const char* displayText) {
+void NotificationManager::DrawNotificationContent(s32 drawX, s32 drawY) {
     // 面板布局
     s32 panelW = PANEL_WIDTH;
     s32 panelH = PANEL_HEIGHT;
@@ -193,16 +247,38 @@ void NotificationManager::DrawNotificationContent(s32 drawX, s32 drawY, const ch
     m_Renderer.DrawRoundedRectPartial(drawX, shadowY, panelW, shadowH, cornerRadius,
                                        {0, 0, 0, 2}, GraphicsRenderer::RoundedRectPart::BOTTOM);
     
-    // 图标
-    s32 iconX = drawX + (s32)(15 * SCALE);
-    s32 iconW = (s32)(40 + 15 + 15) * SCALE;
-    s32 iconSize = (s32)(40 * SCALE);
-    m_Renderer.DrawText(iconStr, iconX, drawY, iconW, panelH, iconSize, {4, 4, 4, 15});
-    
-    // 文本
-    s32 textX = iconX + iconW + (s32)(3 * SCALE) + (s32)(3 * SCALE);
-    s32 textW = panelW - (textX - drawX) - (s32)(15 * SCALE);
-    m_Renderer.DrawText(displayText, textX, drawY, textW, panelH, PANEL_FONT_SIZE, {5, 5, 5, 15}, GraphicsRenderer::TextAlign::LEFT);
+    // 图标和文本（重放排版结果）
+    m_Renderer.DrawTextLayout(m_IconLayout, drawX, drawY, {4, 4, 4, 15});
+    m_Renderer.DrawTextLayout(m_TextLayout, drawX, drawY, {5, 5, 5, 15});
+}
+
+// 将面板预渲染到线性表面
+bool NotificationManager::PreparePanel() {
+    if (!m_LinearSurface) return false;
+    
+    m_Renderer.StartOffscreen();
+    m_Renderer.FillScreen({0, 0, 0, 0});
+    DrawNotificationContent(0, 0);
+    m_Renderer.EndOffscreen();
+    return true;
+}
+
+// 绘制一帧动画
+void NotificationManager::DrawAnimationFrame(s32 contentX, s32 clipX, s32 clipW) {
+    // 没有预渲染面板时可选线性合成（未绑定线性表面时自动退回直接绘制）
+    if (USE_LINEAR_COMPOSITION && !m_PanelCached) m_Renderer.EnableLinearComposition();
+    m_Renderer.StartFrame();
+    m_Renderer.FillScreen({0, 0, 0, 0});
+    if (m_PanelCached) {
+        // 缓存中面板位于 x=0，平移拷贝可见部分
+        m_Renderer.BlitLinear(clipX - contentX, 0, clipW, PANEL_HEIGHT, clipX, 0);
+    } else {
+        m_Renderer.PushClip(clipX, 0, clipW, PANEL_HEIGHT);
+        DrawNotificationContent(contentX, 0);
+        m_Renderer.PopClip();
+    }
+    m_Renderer.EndFrame();
+    m_Renderer.DisableLinearComposition();
 }
 
 // 显示通知弹窗
@@ -228,33 +304,64 @@ void NotificationManager::Show(const char* text, NotificationPosition position,
         while (*displayText == ' ') displayText++;
     }
     
-    // 根据位置执行对应的动画
+    // 重复的通知直接从面板缓存还原，跳过排版和光栅化（文本过长时不缓存）
+    PanelKey panelKey;
+    bool cacheable = PanelCache::MakeKey(panelKey, text, type, PANEL_STYLE_VERSION, FontManager::Instance().GetFontSetIdentity());
+    m_PanelCached = !USE_LINEAR_COMPOSITION && cacheable && m_LinearSurface && m_PanelCache.Fetch(panelKey, m_LinearSurface, FB_WIDTH * FB_HEIGHT);
+    
+    if (!m_PanelCached) {
+        // 排版一次，之后每帧只重放；与上一条通知相同时直接复用排版结果和遮罩
+        if (!cacheable || !m_LayoutValid || !PanelCache::SameKey(m_LayoutKey, panelKey)) {
+            LayoutPanel(iconStr, displayText);
+            m_LayoutKey = panelKey;
+            m_LayoutValid = cacheable;
+        }
+        
+        // 预渲染面板，动画每帧只做拷贝（线性合成时线性表面留给每一帧使用）
+        m_PanelCached = !USE_LINEAR_COMPOSITION && PreparePanel();
+        if (m_PanelCached && cacheable) m_PanelCache.Store(panelKey, m_LinearSurface, FB_WIDTH * FB_HEIGHT);
+    }
+    
+    // 根据位置计算图层目标坐标
     s32 targetY = PANEL_MARGIN_TOP;
+    s32 targetX;
     
     switch (position) {
-        case LEFT: {
-            s32 targetX = PANEL_MARGIN_SIDE;
-            AnimateFromLeft(targetX, targetY, iconStr, displayText);
+        case LEFT:
+            targetX = PANEL_MARGIN_SIDE;
             break;
-        }
-        case RIGHT: {
-            s32 targetX = SCREEN_WIDTH - LAYER_DISPLAY_WIDTH - PANEL_MARGIN_SIDE;
-            AnimateFromRight(targetX, targetY, iconStr, displayText);
+        case RIGHT:
+            targetX = SCREEN_WIDTH - LAYER_DISPLAY_WIDTH - PANEL_MARGIN_SIDE;
             break;
-        }
-        case MIDDLE: {
-            s32 targetX = (SCREEN_WIDTH - LAYER_DISPLAY_WIDTH) / 2;
-            AnimateExpand(targetX, targetY, iconStr, displayText);
+        case MIDDLE:
+        default:
+            targetX = (SCREEN_WIDTH - LAYER_DISPLAY_WIDTH) / 2;
             break;
-        }
-        default: {
-            s32 targetX = (SCREEN_WIDTH - LAYER_DISPLAY_WIDTH) / 2;
+    }
+    
+    // 优先使用图层动画，不可用时回退到 CPU 逐帧绘制
+    // 新面板在滑入结束、停留显示期间才写入 SD 卡，不推迟弹窗出现
+    if (USE_LAYER_ANIMATION && AnimateLayer(position, targetX, targetY)) {
+        m_PanelCache.FlushPending();
+        return;
+    }
+    
+    switch (position) {
+        case LEFT:
+            AnimateFromLeft(targetX, targetY);
+            break;
+        case RIGHT:
+            AnimateFromRight(targetX, targetY);
+            break;
+        case MIDDLE:
+            AnimateExpand(targetX, targetY);
+            break;
+        default:
             viSetLayerPosition(&m_Layer, targetX, targetY);
             break;
-        }
     }
     
-    
+    m_PanelCache.FlushPending();
 }
 
 // 隐藏通知弹窗
@@ -272,15 +379,37 @@ void NotificationManager::Hide() {
 
 
 
-// 缓动函数：快进慢出（EaseOutCubic）
-float NotificationManager::EaseOutCubic(float t) {
-    float f = t - 1.0f;
-    return f * f * f + 1.0f;
+// 图层动画（合成器移动图层，CPU 只绘制一次面板）
+bool NotificationManager::AnimateLayer(NotificationPosition position, s32 targetX, s32 targetY) {
+    // 滑入起点：从目标位置向外偏移一个图层宽度
+    // 展开需要逐帧改变可见范围（缩放图层会拉伸面板），交给 AnimateExpand 按裁剪区域绘制
+    s32 fromX;
+    switch (position) {
+        case LEFT:   fromX = targetX - LAYER_DISPLAY_WIDTH; break;
+        case RIGHT:  fromX = targetX + LAYER_DISPLAY_WIDTH; break;
+        default:     return false;
+    }
+    
+    ViLayerControl control(&m_Layer, &m_VsyncEvent);
+    LayerAnimator animator(control);
+    
+    // 1. 图层放到起点
+    Result rc = animator.PrepareSlide(fromX, targetY);
+    if (R_FAILED(rc)) return false;
+    
+    // 2. 完整面板只绘制一次
+    DrawAnimationFrame(0, 0, PANEL_WIDTH);
+    
+    // 3. 每个垂直同步移动图层
+    rc = animator.Slide(fromX, targetX, targetY, SLIDE_DURATION_MS);
+    
+    // 中途失败：面板已绘制完整，直接落到最终位置
+    if (R_FAILED(rc)) viSetLayerPosition(&m_Layer, targetX, targetY);
+    return true;
 }
 // 左边滑入动画（特斯拉逐帧绘制方式）
-void NotificationManager::AnimateFromLeft(s32 targetX, s32 targetY, const char* iconStr, const char* displayText) {
+void NotificationManager::AnimateFromLeft(s32 targetX, s32 targetY) {
     const int ANIMATION_FRAMES = 15;
-    const s32 SLIDE_DURATION_MS = 250;  // 250ms 滑入时间
     
     // Layer 固定在目标位置
     viSetLayerPosition(&m_Layer, targetX, targetY);
@@ -294,7 +423,7 @@ void NotificationManager::AnimateFromLeft(s32 targetX, s32 targetY, const char*
         float t = (float)elapsedMs / SLIDE_DURATION_MS;
         if (t > 1.0f) t = 1.0f;
         
-        float progress = EaseOutCubic(t);
+        float progress = LayerAnimator::EaseOutCubic(t);
         
         // 计算绘制坐标（从 -PANEL_WIDTH 滑到 0）
         s32 drawX = (s32)(-PANEL_WIDTH + progress * PANEL_WIDTH);
@@ -308,12 +437,7 @@ void NotificationManager::AnimateFromLeft(s32 targetX, s32 targetY, const char*
         }
         
         // 每帧清空+绘制
-        m_Renderer.StartFrame();
-        m_Renderer.FillScreen({0, 0, 0, 0});
-        m_Renderer.EnableScissoring(scissorX, 0, scissorW, PANEL_HEIGHT);
-        DrawNotificationContent(drawX, 0, iconStr, displayText);
-        m_Renderer.DisableScissoring();
-        m_Renderer.EndFrame();
+        DrawAnimationFrame(drawX, scissorX, scissorW);
         
         if (t >= 1.0f) break;
         svcSleepThread(16666667);  // 16.6ms
@@ -321,9 +445,8 @@ void NotificationManager::AnimateFromLeft(s32 targetX, s32 targetY, const char*
 }
 
 // 右边滑入动画（特斯拉逐帧绘制方式）
-void NotificationManager::AnimateFromRight(s32 targetX, s32 targetY, const char* iconStr, const char* displayText) {
+void NotificationManager::AnimateFromRight(s32 targetX, s32 targetY) {
     const int ANIMATION_FRAMES = 15;
-    const s32 SLIDE_DURATION_MS = 250;  // 250ms 滑入时间
     
     // Layer 固定在目标位置
     viSetLayerPosition(&m_Layer, targetX, targetY);
@@ -337,7 +460,7 @@ void NotificationManager::AnimateFromRight(s32 targetX, s32 targetY, const char*
         float t = (float)elapsedMs / SLIDE_DURATION_MS;
         if (t > 1.0f) t = 1.0f;
         
-        float progress = EaseOutCubic(t);
+        float progress = LayerAnimator::EaseOutCubic(t);
         
         // 计算绘制坐标（从 PANEL_WIDTH 滑到 0）
         s32 drawX = (s32)(PANEL_WIDTH - progress * PANEL_WIDTH);
@@ -351,12 +474,7 @@ void NotificationManager::AnimateFromRight(s32 targetX, s32 targetY, const char*
         }
         
         // 每帧清空+绘制
-        m_Renderer.StartFrame();
-        m_Renderer.FillScreen({0, 0, 0, 0});
-        m_Renderer.EnableScissoring(scissorX, 0, scissorW, PANEL_HEIGHT);
-        DrawNotificationContent(drawX, 0, iconStr, displayText);
-        m_Renderer.DisableScissoring();
-        m_Renderer.EndFrame();
+        DrawAnimationFrame(drawX, scissorX, scissorW);
         
         if (t >= 1.0f) break;
         svcSleepThread(16666667);  // 16.6ms
@@ -364,9 +482,8 @@ void NotificationManager::AnimateFromRight(s32 targetX, s32 targetY, const char*
 }
 
 // 中间展开动画（从中心向两边扩展）
-void NotificationManager::AnimateExpand(s32 targetX, s32 targetY, const char* iconStr, const char* displayText) {
+void NotificationManager::AnimateExpand(s32 targetX, s32 targetY) {
     const int ANIMATION_FRAMES = 15;
-    const s32 EXPAND_DURATION_MS = 400;  // 400ms 展开时间
     
     // Layer 固定在目标位置
     viSetLayerPosition(&m_Layer, targetX, targetY);
@@ -380,7 +497,7 @@ void NotificationManager::AnimateExpand(s32 targetX, s32 targetY, const char* ic
         float t = (float)elapsedMs / EXPAND_DURATION_MS;
         if (t > 1.0f) t = 1.0f;
         
-        float progress = EaseOutCubic(t);
+        float progress = LayerAnimator::EaseOutCubic(t);
         
         // 计算当前宽度（从 0 扩展到 PANEL_WIDTH）
         s32 currentWidth = (s32)(progress * PANEL_WIDTH);
@@ -396,13 +513,8 @@ void NotificationManager::AnimateExpand(s32 targetX, s32 targetY, const char* ic
         s32 scissorX = drawX;
         s32 scissorW = currentWidth;
         
-        // 每帧清空+绘制
-        m_Renderer.StartFrame();
-        m_Renderer.FillScreen({0, 0, 0, 0});
-        m_Renderer.EnableScissoring(scissorX, 0, scissorW, PANEL_HEIGHT);
-        DrawNotificationContent(0, 0, iconStr, displayText);  // 完整内容在 x=0 处
-        m_Renderer.DisableScissoring();
-        m_Renderer.EndFrame();
+        // 每帧清空+绘制（完整内容在 x=0 处）
+        DrawAnimationFrame(0, scissorX, scissorW);
         
         if (t >= 1.0f) break;
         svcSleepThread(16666667);  // 16.6ms
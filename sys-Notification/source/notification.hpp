@@ -2,6 +2,7 @@
 
 #include <switch.h>
 #include "graphics.hpp"
+#include "panel_cache.hpp"
 
 // 通知位置枚举
 enum NotificationPosition {
@@ -32,6 +33,13 @@ public:
     // 隐藏通知弹窗
     void Hide();
     
+    // 设置面板缓存的 SD 卡目录（不设置则只在内存中缓存）
+    void SetCacheDirectory(const char* dir) { m_PanelCache.SetDirectory(dir); }
+    
+    // 面板缓存命中/未命中次数
+    u32 GetPanelCacheHits() const { return m_PanelCache.GetHits(); }
+    u32 GetPanelCacheMisses() const { return m_PanelCache.GetMisses(); }
+    
 private:
     // 核心图形资源
     ViDisplay m_Display;              // VI 显示对象
@@ -42,6 +50,16 @@ private:
     
     // 图形渲染器
     GraphicsRenderer m_Renderer;
+    u16* m_LinearSurface;             // 线性合成表面（分配失败时为空，直接绘制到帧缓冲）
+    
+    // 当前通知的排版结果（面板坐标系，原点在面板左上角），带覆盖率遮罩
+    TextLayout m_IconLayout;          // 图标
+    TextLayout m_TextLayout;          // 文本
+    PanelKey m_LayoutKey;             // 排版结果对应的面板缓存键（逐字段相同时直接复用）
+    bool m_LayoutValid;               // 排版结果是否有效
+    
+    // 已渲染面板缓存（重复通知跳过排版和光栅化）
+    PanelCache m_PanelCache;
     
     // 配置参数
     u16 m_FramebufferWidth;           // 帧缓冲宽度 (400)
@@ -53,6 +71,7 @@ private:
     
     // 状态标志
     bool m_Initialized;               // 是否已初始化
+    bool m_PanelCached;               // 线性表面中是否为当前通知的预渲染面板
     
     // 将图层添加到显示栈
     static Result ViAddToLayerStack(ViLayer* layer, ViLayerStack stack);
@@ -60,14 +79,24 @@ private:
     // 恢复系统输入焦点（模拟触屏点击）
     void RestoreSystemInput();
     
-    // 绘制通知内容（不包含动画）
-    void DrawNotificationContent(s32 drawX, s32 drawY, const char* iconStr, const char* displayText);
+    // 排版图标和文本并生成遮罩（每条通知一次）
+    void LayoutPanel(const char* iconStr, const char* displayText);
+    
+    // 绘制通知内容（不包含动画），使用 LayoutPanel 的排版结果
+    void DrawNotificationContent(s32 drawX, s32 drawY);
+    
+    // 将面板预渲染到线性表面（每条通知一次），成功返回 true
+    bool PreparePanel();
+    
+    // 绘制一帧动画：面板内容位于 contentX，只显示 [clipX, clipX + clipW) 列
+    // 面板已缓存时直接拷贝缓存，否则逐帧重绘
+    void DrawAnimationFrame(s32 contentX, s32 clipX, s32 clipW);
     
-    // 动画函数
-    void AnimateFromLeft(s32 targetX, s32 targetY, const char* iconStr, const char* displayText);   // 左边滑入
-    void AnimateFromRight(s32 targetX, s32 targetY, const char* iconStr, const char* displayText);  // 右边滑入
-    void AnimateExpand(s32 targetX, s32 targetY, const char* iconStr, const char* displayText);     // 中间展开
+    // 图层动画（只用于左右滑入）：面板只绘制一次，由合成器移动图层；不适用或图层调用失败时返回 false
+    bool AnimateLayer(NotificationPosition position, s32 targetX, s32 targetY);
     
-    // 缓动函数
-    static float EaseOutCubic(float t);
+    // 动画函数（CPU 逐帧绘制，图层动画的回退路径）
+    void AnimateFromLeft(s32 targetX, s32 targetY);   // 左边滑入
+    void AnimateFromRight(s32 targetX, s32 targetY);  // 右边滑入
+    void AnimateExpand(s32 targetX, s32 targetY);     // 中间展开
 };
@@ -0,0 +1,18 @@
+#include "notification_dispatch.hpp"
+#include <cstring>
+
+// 校验请求并交给接收者
+uint32_t NotificationDispatcher::Dispatch(uint32_t cmdId, const void* data, size_t size) {
+    if (cmdId != NOTIF_CMD_POST) return NOTIF_RESULT_UNKNOWN_CMD;
+    if (!data || size < sizeof(NotifPostRequest)) return NOTIF_RESULT_INVALID_ARG;
+    
+    NotifPostRequest request;
+    memcpy(&request, data, sizeof(request));
+    
+    // 文本必须以 '\0' 结尾且非空
+    if (memchr(request.text, '\0', sizeof(request.text)) == nullptr || request.text[0] == '\0') {
+        return NOTIF_RESULT_INVALID_ARG;
+    }
+    
+    return m_Sink.Post(request);
+}
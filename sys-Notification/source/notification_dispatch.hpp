@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// 只使用 libnotification 的 IPC 协议定义（请求体、命令号、错误码），不依赖 libnx，可在主机上测试
+#define LIBNOTIFICATION_PROTOCOL_ONLY
+#include "libnotification.h"
+
+// 通知请求接收者：由主循环实现，可能在服务线程中被调用
+class NotificationSink {
+public:
+    virtual ~NotificationSink() = default;
+    
+    // 收到一条已校验的通知请求，返回结果码（与 libnx Result 相同），失败时客户端会回退到文件投递
+    virtual uint32_t Post(const NotifPostRequest& request) = 0;
+};
+
+// 请求分发：校验命令号和请求体后交给接收者，与传输方式无关
+class NotificationDispatcher {
+public:
+    explicit NotificationDispatcher(NotificationSink& sink) : m_Sink(sink) {}
+    
+    // data/size 为命令头之后的原始负载
+    uint32_t Dispatch(uint32_t cmdId, const void* data, size_t size);
+    
+private:
+    NotificationSink& m_Sink;
+};
+
+// 传输层接口：负责收取请求并交给分发器
+class NotificationTransport {
+public:
+    virtual ~NotificationTransport() = default;
+    
+    virtual uint32_t Start() = 0;
+    virtual void Stop() = 0;
+};
+
+// 进程内回环传输：直接调用分发器，主机上无需内核端口即可驱动完整请求流程
+class LoopbackTransport : public NotificationTransport {
+public:
+    explicit LoopbackTransport(NotificationDispatcher& dispatcher) : m_Dispatcher(dispatcher) {}
+    
+    uint32_t Start() override { return 0; }
+    void Stop() override {}
+    
+    uint32_t Post(const NotifPostRequest& request) {
+        return m_Dispatcher.Dispatch(NOTIF_CMD_POST, &request, sizeof(request));
+    }
+    
+private:
+    NotificationDispatcher& m_Dispatcher;
+};
@@ -0,0 +1,259 @@
+#include "notification_service.hpp"
+#include <cstring>
+
+// 服务线程栈（静态分配，不占用堆）
+static u8 __attribute__((aligned(0x1000))) s_ServiceStack[SERVICE_STACK_SIZE];
+
+RingTransport::RingTransport(NotificationDispatcher& dispatcher)
+    : m_Dispatcher(dispatcher)
+    , m_Shmem{}
+    , m_WakeEvent{}
+    , m_Ring(nullptr)
+{
+}
+
+RingTransport::~RingTransport() {
+    if (!m_Ring) return;
+    eventClose(&m_WakeEvent);
+    shmemClose(&m_Shmem);
+}
+
+// 首次调用时创建共享内存和唤醒事件，之后重新开放环
+Result RingTransport::Start() {
+    if (m_Ring) {
+        notif_ring_reopen(m_Ring);
+        return 0;
+    }
+    
+    Result rc = shmemCreate(&m_Shmem, NOTIF_RING_SHMEM_SIZE, Perm_Rw, Perm_Rw);
+    if (R_FAILED(rc)) return rc;
+    
+    rc = shmemMap(&m_Shmem);
+    if (R_FAILED(rc)) goto cleanup_shmem;
+    
+    rc = eventCreate(&m_WakeEvent, true);
+    if (R_FAILED(rc)) goto cleanup_shmem;
+    
+    m_Ring = (NotifRing*)shmemGetAddr(&m_Shmem);
+    notif_ring_init(m_Ring);
+    return 0;
+
+cleanup_shmem:
+    shmemClose(&m_Shmem);
+    return rc;
+}
+
+// 关闭环，等待写入中的记录发布
+void RingTransport::Stop() {
+    if (!m_Ring) return;
+    
+    notif_ring_close(m_Ring);
+    for (int i = 0; i < RING_SETTLE_TRIES && !notif_ring_settled(m_Ring); i++) {
+        svcSleepThread(RING_SETTLE_WAIT_NS);
+    }
+}
+
+// 把已发布的记录交给分发器
+void RingTransport::Drain() {
+    if (!m_Ring) return;
+    
+    const void* record;
+    while ((record = notif_ring_front(m_Ring)) != nullptr) {
+        // 先复制出来再校验，客户端可以随时改写共享内存
+        NotifPostRequest request;
+        memcpy(&request, record, sizeof(request));
+        
+        // 接收者队列已满时留在环中，下次再取；无效记录直接丢弃
+        if (m_Dispatcher.Dispatch(NOTIF_CMD_POST, &request, sizeof(request)) == NOTIF_RESULT_QUEUE_FULL) break;
+        notif_ring_pop(m_Ring);
+    }
+}
+
+bool RingTransport::HasPending() {
+    return m_Ring && notif_ring_front(m_Ring) != nullptr;
+}
+
+bool RingTransport::PrepareWait() {
+    return !m_Ring || notif_ring_prepare_wait(m_Ring);
+}
+
+void RingTransport::CancelWait() {
+    if (m_Ring) notif_ring_cancel_wait(m_Ring);
+}
+
+bool RingTransport::GetHandles(Handle* shmem, Handle* wake) {
+    if (!m_Ring) return false;
+    *shmem = shmemGetHandle(&m_Shmem);
+    *wake = m_WakeEvent.wevent;
+    return true;
+}
+
+IpcTransport::IpcTransport(NotificationDispatcher& dispatcher)
+    : m_Dispatcher(dispatcher)
+    , m_Ring(nullptr)
+    , m_Thread{}
+    , m_StopEvent{}
+    , m_Port(INVALID_HANDLE)
+    , m_Sessions{}
+    , m_SessionCount(0)
+    , m_Running(false)
+{
+}
+
+IpcTransport::~IpcTransport() {
+    Stop();
+}
+
+// 注册命名端口并启动服务线程
+Result IpcTransport::Start() {
+    if (m_Running) return 0;
+    
+    Result rc = eventCreate(&m_StopEvent, false);
+    if (R_FAILED(rc)) return rc;
+    
+    rc = svcManageNamedPort(&m_Port, NOTIF_SERVICE_NAME, SERVICE_MAX_SESSIONS);
+    if (R_FAILED(rc)) goto cleanup_event;
+    
+    rc = threadCreate(&m_Thread, ThreadEntry, this, s_ServiceStack, sizeof(s_ServiceStack), SERVICE_THREAD_PRIO, -2);
+    if (R_FAILED(rc)) goto cleanup_service;
+    
+    rc = threadStart(&m_Thread);
+    if (R_FAILED(rc)) goto cleanup_thread;
+    
+    m_Running = true;
+    return 0;
+
+cleanup_thread:
+    threadClose(&m_Thread);
+cleanup_service:
+    UnregisterPort();
+    svcCloseHandle(m_Port);
+    m_Port = INVALID_HANDLE;
+cleanup_event:
+    eventClose(&m_StopEvent);
+    return rc;
+}
+
+// 注销命名端口、停止线程并关闭所有会话
+void IpcTransport::Stop() {
+    if (!m_Running) return;
+    
+    // 先注销，新的客户端连接立即失败并回退到文件投递
+    UnregisterPort();
+    
+    eventFire(&m_StopEvent);
+    threadWaitForExit(&m_Thread);
+    threadClose(&m_Thread);
+    eventClose(&m_StopEvent);
+    
+    while (m_SessionCount > 0) CloseSession(m_SessionCount - 1);
+    svcCloseHandle(m_Port);
+    m_Port = INVALID_HANDLE;
+    m_Running = false;
+}
+
+void IpcTransport::ThreadEntry(void* arg) {
+    static_cast<IpcTransport*>(arg)->ThreadMain();
+}
+
+// 服务循环：句柄 0 为退出事件，1 为服务端口，之后为各会话
+void IpcTransport::ThreadMain() {
+    Handle replyTarget = INVALID_HANDLE;
+    
+    while (true) {
+        Handle handles[2 + SERVICE_MAX_SESSIONS];
+        s32 count = 0;
+        handles[count++] = m_StopEvent.revent;
+        handles[count++] = m_Port;
+        for (s32 i = 0; i < m_SessionCount; i++) handles[count++] = m_Sessions[i];
+        
+        s32 index = -1;
+        Result rc = svcReplyAndReceive(&index, handles, count, replyTarget, UINT64_MAX);
+        replyTarget = INVALID_HANDLE;
+        
+        if (R_FAILED(rc)) {
+            // 客户端断开，关闭对应会话
+            if (rc == KERNELRESULT(ConnectionClosed) && index >= 2) CloseSession(index - 2);
+            continue;
+        }
+        
+        // 退出事件
+        if (index == 0) break;
+        
+        // 新连接，会话已满时直接拒绝
+        if (index == 1) {
+            Handle session;
+            if (R_SUCCEEDED(svcAcceptSession(&session, m_Port))) {
+                if (m_SessionCount < SERVICE_MAX_SESSIONS) m_Sessions[m_SessionCount++] = session;
+                else svcCloseHandle(session);
+            }
+            continue;
+        }
+        
+        // 会话请求：处理后在下一次等待时回复
+        if (HandleRequest()) replyTarget = m_Sessions[index - 2];
+        else CloseSession(index - 2);
+    }
+}
+
+// 处理 TLS 中收到的请求并写入回复
+bool IpcTransport::HandleRequest() {
+    void* base = armGetTls();
+    HipcParsedRequest hipc = hipcParseRequest(base);
+    
+    if (hipc.meta.type == CmifCommandType_Close) return false;
+    
+    Result rc = NOTIF_RESULT_UNKNOWN_CMD;
+    if (hipc.meta.type == CmifCommandType_Request || hipc.meta.type == CmifCommandType_RequestWithContext) {
+        u8* words = (u8*)hipc.data.data_words;
+        size_t dataSize = hipc.meta.num_data_words * sizeof(u32);
+        CmifInHeader* header = (CmifInHeader*)cmifGetAlignedDataStart(hipc.data.data_words, base);
+        size_t headerEnd = ((u8*)header - words) + sizeof(CmifInHeader);
+        
+        if (headerEnd <= dataSize && header->magic == CMIF_IN_HEADER_MAGIC && header->command_id == NOTIF_CMD_OPEN_RING) {
+            // 转交共享内存环和唤醒事件
+            Handle handles[2];
+            if (m_Ring && m_Ring->GetHandles(&handles[0], &handles[1])) {
+                WriteResponse(0, handles, 2);
+                return true;
+            }
+            rc = NOTIF_RESULT_UNAVAILABLE;
+        } else if (headerEnd <= dataSize && header->magic == CMIF_IN_HEADER_MAGIC) {
+            rc = m_Dispatcher.Dispatch(header->command_id, header + 1, dataSize - headerEnd);
+        } else {
+            rc = NOTIF_RESULT_INVALID_ARG;
+        }
+    }
+    
+    WriteResponse(rc);
+    return true;
+}
+
+// 在 TLS 中写入回复（结果码 + 可选的复制句柄）
+void IpcTransport::WriteResponse(Result rc, const Handle* copyHandles, u32 numCopyHandles) {
+    void* base = armGetTls();
+    
+    HipcMetadata meta = {};
+    meta.type = CmifCommandType_Request;
+    meta.num_data_words = (sizeof(CmifOutHeader) + 0x10) / sizeof(u32);
+    meta.num_copy_handles = numCopyHandles;
+    HipcRequest hipc = hipcMakeRequest(base, meta);
+    for (u32 i = 0; i < numCopyHandles; i++) hipc.copy_handles[i] = copyHandles[i];
+    
+    CmifOutHeader* header = (CmifOutHeader*)cmifGetAlignedDataStart(hipc.data_words, base);
+    header->magic = CMIF_OUT_HEADER_MAGIC;
+    header->version = 0;
+    header->result = rc;
+    header->token = 0;
+}
+
+// 最大会话数为 0 时内核删除命名端口，不返回新句柄
+void IpcTransport::UnregisterPort() {
+    Handle unused;
+    svcManageNamedPort(&unused, NOTIF_SERVICE_NAME, 0);
+}
+
+void IpcTransport::CloseSession(s32 index) {
+    svcCloseHandle(m_Sessions[index]);
+    m_Sessions[index] = m_Sessions[--m_SessionCount];
+}
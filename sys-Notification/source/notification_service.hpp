@@ -0,0 +1,87 @@
+#pragma once
+
+#include <switch.h>
+
+#include "notification_dispatch.hpp"
+
+// 服务配置
+#define SERVICE_MAX_SESSIONS  4          // 同时连接的客户端数
+#define SERVICE_THREAD_PRIO   0x2C       // 服务线程优先级（高于主线程）
+#define SERVICE_STACK_SIZE    0x2000     // 服务线程栈大小
+#define RING_SETTLE_WAIT_NS   1000000ULL // 关闭环时等待客户端写完的间隔（1ms）
+#define RING_SETTLE_TRIES     10         // 最多等待次数（客户端异常退出时放弃）
+
+// 共享内存环传输：客户端无锁写入环，主循环取出后交给分发器
+// 共享内存和唤醒事件由 IPC 服务（NOTIF_CMD_OPEN_RING）转交给客户端
+class RingTransport : public NotificationTransport {
+public:
+    explicit RingTransport(NotificationDispatcher& dispatcher);
+    ~RingTransport();
+    
+    // 首次调用时创建共享内存和唤醒事件，之后重新开放环
+    Result Start() override;
+    
+    // 关闭环（客户端改用其他方式投递），等待写入中的记录发布，已写入的记录仍可取出
+    void Stop() override;
+    
+    // 把已发布的记录交给分发器，直到环为空或接收者队列已满
+    void Drain();
+    
+    // 环中是否还有已发布但未取出的记录
+    bool HasPending();
+    
+    // 主循环休眠前调用：环为空时返回 true，之后写入的记录会触发唤醒事件
+    bool PrepareWait();
+    void CancelWait();
+    
+    bool IsActive() const { return m_Ring != nullptr; }
+    Event* GetWakeEvent() { return &m_WakeEvent; }
+    
+    // 转交给客户端的句柄（共享内存、唤醒事件写端），环不可用时返回 false
+    bool GetHandles(Handle* shmem, Handle* wake);
+    
+private:
+    NotificationDispatcher& m_Dispatcher;
+    SharedMemory m_Shmem;
+    Event m_WakeEvent;
+    NotifRing* m_Ring;                          // 映射后的环，未创建时为空
+};
+
+// 内核命名端口上的 IPC 服务（NOTIF_SERVICE_NAME），在独立线程中收取请求
+class IpcTransport : public NotificationTransport {
+public:
+    explicit IpcTransport(NotificationDispatcher& dispatcher);
+    ~IpcTransport();
+    
+    // 设置要转交给客户端的共享内存环（在 Start 之前调用）
+    void SetRing(RingTransport* ring) { m_Ring = ring; }
+    
+    // 注册命名端口并启动服务线程
+    Result Start() override;
+    
+    // 注销命名端口、停止线程并关闭所有会话
+    void Stop() override;
+    
+private:
+    NotificationDispatcher& m_Dispatcher;
+    RingTransport* m_Ring;
+    Thread m_Thread;
+    Event m_StopEvent;                          // 通知服务线程退出
+    Handle m_Port;                              // 命名端口（服务端）
+    Handle m_Sessions[SERVICE_MAX_SESSIONS];    // 客户端会话
+    s32 m_SessionCount;
+    bool m_Running;
+    
+    static void ThreadEntry(void* arg);
+    void ThreadMain();
+    
+    // 处理 TLS 中收到的请求并写入回复，会话要求关闭时返回 false
+    bool HandleRequest();
+    
+    // 在 TLS 中写入回复（结果码 + 可选的复制句柄）
+    static void WriteResponse(Result rc, const Handle* copyHandles = nullptr, u32 numCopyHandles = 0);
+    
+    static void UnregisterPort();
+    
+    void CloseSession(s32 index);
+};
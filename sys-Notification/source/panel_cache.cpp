@@ -0,0 +1,295 @@
+#include "panel_cache.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// SD 卡缓存文件：PanelFileHeader + textLength 字节文本 + runCount 个 (长度, 像素值) 对
+// 文件名只由哈希决定槽位，读取时用文件中的完整键确认
+#define PANEL_FILE_MAGIC   0x4C4E504E    // "NPNL"
+#define PANEL_FILE_VERSION 2
+
+// 单个面板文件大小上限（超过视为损坏）
+#define PANEL_FILE_MAX_RUNS 0x8000
+
+namespace {
+
+struct PanelFileHeader {
+    u32 magic;
+    u32 version;
+    u32 type;
+    u32 style;
+    u32 fontIdentity;
+    u32 textLength;                // 不含结尾 0
+    u32 pixelCount;
+    u32 runCount;
+};
+
+}
+
+PanelCache::PanelCache()
+    : m_Entries{}
+    , m_Bytes(0)
+    , m_UseClock(0)
+    , m_Hits(0)
+    , m_Misses(0)
+    , m_Directory(nullptr)
+{
+}
+
+PanelCache::~PanelCache() {
+    for (int i = 0; i < PANEL_CACHE_ENTRIES; i++) {
+        if (m_Entries[i].used) free(m_Entries[i].runs);
+    }
+}
+
+// 生成缓存键：保存全部字段，哈希用 FNV-1a
+bool PanelCache::MakeKey(PanelKey& key, const char* text, u32 type, u32 style, u32 fontIdentity) {
+    if (!text) text = "";
+    size_t len = strlen(text);
+    if (len >= PANEL_KEY_TEXT_MAX) return false;
+    
+    memset(&key, 0, sizeof(key));
+    memcpy(key.text, text, len);
+    key.type = type;
+    key.style = style;
+    key.fontIdentity = fontIdentity;
+    
+    u32 hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) hash = (hash ^ (u8)text[i]) * 16777619u;
+    hash = (hash ^ type) * 16777619u;
+    hash = (hash ^ style) * 16777619u;
+    hash = (hash ^ fontIdentity) * 16777619u;
+    key.hash = hash;
+    return true;
+}
+
+bool PanelCache::SameKey(const PanelKey& a, const PanelKey& b) {
+    return a.hash == b.hash && a.type == b.type && a.style == b.style &&
+           a.fontIdentity == b.fontIdentity && strcmp(a.text, b.text) == 0;
+}
+
+void PanelCache::SetDirectory(const char* dir) {
+    m_Directory = dir;
+}
+
+// 查找缓存：先查内存，再查 SD 卡
+bool PanelCache::Fetch(const PanelKey& key, u16* pixels, u32 count) {
+    Entry* e = Find(key);
+    if (e && e->pixelCount == count && Decode(e->runs, e->runCount, pixels, count)) {
+        e->lastUse = ++m_UseClock;
+        m_Hits++;
+        return true;
+    }
+    
+#if PANEL_CACHE_ON_SD
+    u32 runCount = 0;
+    u16* runs = ReadFile(key, count, &runCount);
+    if (runs) {
+        if (Decode(runs, runCount, pixels, count)) {
+            Insert(key, runs, runCount, count);
+            m_Hits++;
+            return true;
+        }
+        free(runs);
+    }
+#endif
+    
+    m_Misses++;
+    return false;
+}
+
+// 压缩并放入内存缓存：Store 在面板显示之前调用，SD 卡写入推迟到 FlushPending
+void PanelCache::Store(const PanelKey& key, const u16* pixels, u32 count) {
+    u32 runCount = CountRuns(pixels, count);
+    u16* runs = (u16*)malloc(runCount * 2 * sizeof(u16));
+    if (!runs) return;
+    Encode(pixels, count, runs);
+    
+    Insert(key, runs, runCount, count);
+    
+#if PANEL_CACHE_ON_SD
+    Entry* e = Find(key);
+    if (e) e->dirty = true;
+#endif
+}
+
+// 写入所有待写入的面板
+void PanelCache::FlushPending() {
+#if PANEL_CACHE_ON_SD
+    for (int i = 0; i < PANEL_CACHE_ENTRIES; i++) {
+        Entry& e = m_Entries[i];
+        if (!e.used || !e.dirty) continue;
+        WriteFile(e.key, e.runs, e.runCount, e.pixelCount);
+        e.dirty = false;
+    }
+#endif
+}
+
+PanelCache::Entry* PanelCache::Find(const PanelKey& key) {
+    for (int i = 0; i < PANEL_CACHE_ENTRIES; i++) {
+        if (m_Entries[i].used && SameKey(m_Entries[i].key, key)) return &m_Entries[i];
+    }
+    return nullptr;
+}
+
+// 淘汰最久未使用的条目，没有可淘汰的返回 false
+bool PanelCache::EvictLeastRecentlyUsed() {
+    Entry* victim = nullptr;
+    for (int i = 0; i < PANEL_CACHE_ENTRIES; i++) {
+        Entry& e = m_Entries[i];
+        if (e.used && (!victim || e.lastUse < victim->lastUse)) victim = &e;
+    }
+    if (!victim) return false;
+    
+    free(victim->runs);
+    m_Bytes -= victim->runCount * 2 * sizeof(u16);
+    victim->used = false;
+    return true;
+}
+
+// 放入内存缓存（接管 runs 的所有权）：超出预算或条目已满时按 LRU 淘汰
+void PanelCache::Insert(const PanelKey& key, u16* runs, u32 runCount, u32 pixelCount) {
+    u32 bytes = runCount * 2 * sizeof(u16);
+    
+    // 同键旧条目先移除
+    Entry* old = Find(key);
+    if (old) {
+        free(old->runs);
+        m_Bytes -= old->runCount * 2 * sizeof(u16);
+        old->used = false;
+    }
+    
+    if (bytes > PANEL_CACHE_BUDGET) {
+        free(runs);
+        return;
+    }
+    
+    while (m_Bytes + bytes > PANEL_CACHE_BUDGET) {
+        if (!EvictLeastRecentlyUsed()) break;
+    }
+    
+    Entry* slot = nullptr;
+    while (!slot) {
+        for (int i = 0; i < PANEL_CACHE_ENTRIES && !slot; i++) {
+            if (!m_Entries[i].used) slot = &m_Entries[i];
+        }
+        if (!slot && !EvictLeastRecentlyUsed()) {
+            free(runs);
+            return;
+        }
+    }
+    
+    slot->key = key;
+    slot->runs = runs;
+    slot->runCount = runCount;
+    slot->pixelCount = pixelCount;
+    slot->lastUse = ++m_UseClock;
+    slot->used = true;
+    slot->dirty = false;
+    m_Bytes += bytes;
+}
+
+// 统计游程数（单个游程最长 0xFFFF）
+u32 PanelCache::CountRuns(const u16* pixels, u32 count) {
+    u32 runs = 0;
+    u32 i = 0;
+    while (i < count) {
+        u32 j = i + 1;
+        while (j < count && pixels[j] == pixels[i] && j - i < 0xFFFF) j++;
+        runs++;
+        i = j;
+    }
+    return runs;
+}
+
+// 编码为 (长度, 像素值) 对
+void PanelCache::Encode(const u16* pixels, u32 count, u16* runs) {
+    u32 i = 0;
+    while (i < count) {
+        u32 j = i + 1;
+        while (j < count && pixels[j] == pixels[i] && j - i < 0xFFFF) j++;
+        *runs++ = (u16)(j - i);
+        *runs++ = pixels[i];
+        i = j;
+    }
+}
+
+// 解码，长度不符时返回 false
+bool PanelCache::Decode(const u16* runs, u32 runCount, u16* pixels, u32 count) {
+    u32 pos = 0;
+    for (u32 r = 0; r < runCount; r++) {
+        u32 len = runs[r * 2];
+        u16 value = runs[r * 2 + 1];
+        if (pos + len > count) return false;
+        for (u32 i = 0; i < len; i++) pixels[pos + i] = value;
+        pos += len;
+    }
+    return pos == count;
+}
+
+// 文件名按哈希选择槽位，目录中最多 PANEL_CACHE_SD_SLOTS 个面板文件
+void PanelCache::MakePath(char* out, size_t size, const PanelKey& key) const {
+    snprintf(out, size, "%s/panel_%02u.bin", m_Directory, (unsigned int)(key.hash % PANEL_CACHE_SD_SLOTS));
+}
+
+// 从 SD 卡读取面板（返回 malloc 的游程数据，失败返回 nullptr）
+u16* PanelCache::ReadFile(const PanelKey& key, u32 pixelCount, u32* outRunCount) {
+    if (!m_Directory) return nullptr;
+    
+    char path[256];
+    MakePath(path, sizeof(path), key);
+    
+    FILE* file = fopen(path, "rb");
+    if (!file) return nullptr;
+    
+    // 槽位可能属于另一个面板：完整比较键
+    PanelFileHeader header;
+    char text[PANEL_KEY_TEXT_MAX];
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != PANEL_FILE_MAGIC ||
+        header.version != PANEL_FILE_VERSION ||
+        header.type != key.type ||
+        header.style != key.style ||
+        header.fontIdentity != key.fontIdentity ||
+        header.textLength != strlen(key.text) ||
+        header.pixelCount != pixelCount ||
+        header.runCount == 0 || header.runCount > PANEL_FILE_MAX_RUNS ||
+        fread(text, 1, header.textLength, file) != header.textLength ||
+        memcmp(text, key.text, header.textLength) != 0) {
+        fclose(file);
+        return nullptr;
+    }
+    
+    u16* runs = (u16*)malloc(header.runCount * 2 * sizeof(u16));
+    if (runs && fread(runs, 2 * sizeof(u16), header.runCount, file) != header.runCount) {
+        free(runs);
+        runs = nullptr;
+    }
+    fclose(file);
+    
+    *outRunCount = header.runCount;
+    return runs;
+}
+
+// 写入 SD 卡（先写临时文件再重命名，替换同槽位的旧面板）
+void PanelCache::WriteFile(const PanelKey& key, const u16* runs, u32 runCount, u32 pixelCount) {
+    if (!m_Directory || runCount > PANEL_FILE_MAX_RUNS) return;
+    
+    char path[256];
+    char tempPath[sizeof(path) + 8];
+    MakePath(path, sizeof(path), key);
+    snprintf(tempPath, sizeof(tempPath), "%s.temp", path);
+    
+    FILE* file = fopen(tempPath, "wb");
+    if (!file) return;
+    
+    u32 textLength = strlen(key.text);
+    PanelFileHeader header = {PANEL_FILE_MAGIC, PANEL_FILE_VERSION, key.type, key.style, key.fontIdentity, textLength, pixelCount, runCount};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(key.text, 1, textLength, file) == textLength &&
+              fwrite(runs, 2 * sizeof(u16), runCount, file) == runCount;
+    if (fclose(file) != 0) ok = false;
+    
+    if (ok) remove(path);
+    if (!ok || rename(tempPath, path) != 0) remove(tempPath);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <switch.h>
+
+// 面板缓存配置
+#define PANEL_CACHE_ENTRIES  8           // 内存中最多缓存的面板数
+#define PANEL_CACHE_BUDGET   0x4000      // 内存中压缩数据总字节预算（16 KB）
+#define PANEL_CACHE_ON_SD    1           // 是否同时持久化到 SD 卡
+#define PANEL_CACHE_SD_SLOTS 32          // SD 卡上最多保存的面板文件数（按键直接映射，同槽位新面板覆盖旧面板）
+#define PANEL_KEY_TEXT_MAX   128         // 可缓存的最长文本（字节，含结尾 0），更长的通知不缓存
+
+// 面板缓存键：哈希只用于快速比较和选择 SD 卡槽位，命中时必须逐字段比较
+struct PanelKey {
+    u32 hash;                            // 以下字段的 FNV-1a
+    u32 type;
+    u32 style;
+    u32 fontIdentity;
+    char text[PANEL_KEY_TEXT_MAX];
+};
+
+// 已渲染面板缓存：重复的通知直接还原位图，跳过排版和光栅化
+// 面板以 RLE（游程长度, 像素值）对压缩存储，纯色背景占绝大部分，压缩率很高
+class PanelCache {
+public:
+    PanelCache();
+    ~PanelCache();
+    
+    // 生成缓存键（文本 + 类型 + 样式版本 + 字体身份），文本过长无法缓存时返回 false
+    static bool MakeKey(PanelKey& key, const char* text, u32 type, u32 style, u32 fontIdentity);
+    
+    // 两个键是否表示同一个面板
+    static bool SameKey(const PanelKey& a, const PanelKey& b);
+    
+    // 设置 SD 卡缓存目录（为空则只在内存中缓存）
+    void SetDirectory(const char* dir);
+    
+    // 查找并解压到 pixels（count 个像素），命中返回 true
+    bool Fetch(const PanelKey& key, u16* pixels, u32 count);
+    
+    // 压缩 pixels 放入内存缓存，SD 卡写入留到 FlushPending
+    void Store(const PanelKey& key, const u16* pixels, u32 count);
+    
+    // 把尚未写入 SD 卡的面板写入 SD 卡（面板显示出来之后再调用）
+    void FlushPending();
+    
+    // 命中/未命中次数
+    u32 GetHits() const { return m_Hits; }
+    u32 GetMisses() const { return m_Misses; }
+    
+private:
+    struct Entry {
+        PanelKey key;
+        u16* runs;                 // (长度, 像素值) 对
+        u32 runCount;              // 对数
+        u32 pixelCount;            // 解压后像素数
+        u32 lastUse;               // 最近使用时间（用于 LRU 淘汰）
+        bool used;
+        bool dirty;                // 尚未写入 SD 卡（写入前被淘汰则不再写入）
+    };
+    
+    Entry m_Entries[PANEL_CACHE_ENTRIES];
+    u32 m_Bytes;                   // 当前压缩数据总字节数
+    u32 m_UseClock;                // LRU 计数器
+    u32 m_Hits;
+    u32 m_Misses;
+    const char* m_Directory;       // SD 卡缓存目录
+    
+    // 内存缓存操作
+    Entry* Find(const PanelKey& key);
+    bool EvictLeastRecentlyUsed();
+    void Insert(const PanelKey& key, u16* runs, u32 runCount, u32 pixelCount);
+    
+    // RLE 编解码
+    static u32 CountRuns(const u16* pixels, u32 count);
+    static void Encode(const u16* pixels, u32 count, u16* runs);
+    static bool Decode(const u16* runs, u32 runCount, u16* pixels, u32 count);
+    
+    // SD 卡读写
+    void MakePath(char* out, size_t size, const PanelKey& key) const;
+    u16* ReadFile(const PanelKey& key, u32 pixelCount, u32* outRunCount);
+    void WriteFile(const PanelKey& key, const u16* runs, u32 runCount, u32 pixelCount);
+};
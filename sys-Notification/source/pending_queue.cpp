@@ -0,0 +1,126 @@
+#include "pending_queue.hpp"
+#include "SimpleFs.hpp"
+#include <cstdio>
+#include <cstring>
+
+PendingQueue::PendingQueue()
+    : m_Entries{}
+    , m_Head(0)
+    , m_Count(0)
+    , m_Incomplete(false)
+    , m_Directory(nullptr)
+    , m_PathBuffer{}
+{
+}
+
+// 扫描目录重建队列（一次扫描排序一次）
+int PendingQueue::Scan(const char* dir_path) {
+    m_Head = 0;
+    m_Count = 0;
+    m_Incomplete = false;
+    m_Directory = dir_path;
+    
+    bool hasTemp = false;
+    SimpleFs::ScanNotificationFiles(dir_path, OnFile, this, &hasTemp);
+    if (hasTemp) m_Incomplete = true;
+    return m_Count;
+}
+
+const char* PendingQueue::Front() {
+    if (Empty()) return nullptr;
+    
+    snprintf(m_PathBuffer, sizeof(m_PathBuffer), "%s/%s", m_Directory, m_Entries[m_Head].name);
+    return m_PathBuffer;
+}
+
+void PendingQueue::Pop() {
+    if (!Empty()) m_Head++;
+}
+
+void PendingQueue::OnFile(const char* name, void* user) {
+    static_cast<PendingQueue*>(user)->Insert(name);
+}
+
+// 插入有序位置，队列已满时丢弃最新的
+void PendingQueue::Insert(const char* name) {
+    // 文件名过长的不是本模块的通知文件
+    if (strlen(name) >= PENDING_NAME_MAX) return;
+    
+    Entry entry = {};
+    strcpy(entry.name, name);
+    
+    // 带序号的文件名无需访问文件系统；旧版文件名取修改时间
+    entry.sequenced = ParseSequencedName(name, &entry);
+    if (!entry.sequenced) {
+        snprintf(m_PathBuffer, sizeof(m_PathBuffer), "%s/%s", m_Directory, name);
+        entry.mtime = SimpleFs::GetModifiedTime(m_PathBuffer);
+    }
+    
+    // 队列已满：这个或被挤出的文件留到下次扫描
+    if (m_Count == PENDING_QUEUE_SIZE) m_Incomplete = true;
+    
+    int pos = m_Count;
+    while (pos > 0 && Before(entry, m_Entries[pos - 1])) pos--;
+    if (pos == PENDING_QUEUE_SIZE) return;
+    
+    int last = (m_Count < PENDING_QUEUE_SIZE) ? m_Count : PENDING_QUEUE_SIZE - 1;
+    memmove(&m_Entries[pos + 1], &m_Entries[pos], (last - pos) * sizeof(Entry));
+    
+    m_Entries[pos] = entry;
+    if (m_Count < PENDING_QUEUE_SIZE) m_Count++;
+}
+
+// 解析十六进制数字段，返回字段之后的位置，没有数字返回 nullptr
+static const char* ParseHex(const char* p, u64* out) {
+    u64 value = 0;
+    const char* start = p;
+    
+    while (true) {
+        char c = *p;
+        u32 digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else break;
+        
+        if (p - start >= 16) return nullptr;  // 超过 64 位
+        value = (value << 4) | digit;
+        p++;
+    }
+    
+    if (p == start) return nullptr;
+    *out = value;
+    return p;
+}
+
+// 解析 notif_<tick>_<pid>_<counter>.ntf（旧版客户端为 .ini）
+bool PendingQueue::ParseSequencedName(const char* name, Entry* out) {
+    if (strncmp(name, "notif_", 6) != 0) return false;
+    
+    u64 tick, pid, counter;
+    const char* p = ParseHex(name + 6, &tick);
+    if (!p || *p != '_') return false;
+    p = ParseHex(p + 1, &pid);
+    if (!p || *p != '_') return false;
+    p = ParseHex(p + 1, &counter);
+    if (!p || *p != '.' || counter > 0xFFFFFFFFULL) return false;
+    
+    out->tick = tick;
+    out->pid = pid;
+    out->counter = (u32)counter;
+    return true;
+}
+
+// 排序规则：旧版文件名在前（按修改时间、文件名），带序号的按 (时钟, 进程ID, 计数)
+bool PendingQueue::Before(const Entry& a, const Entry& b) {
+    if (a.sequenced != b.sequenced) return !a.sequenced;
+    
+    if (!a.sequenced) {
+        if (a.mtime != b.mtime) return a.mtime < b.mtime;
+        return strcmp(a.name, b.name) < 0;
+    }
+    
+    if (a.tick != b.tick) return a.tick < b.tick;
+    if (a.pid != b.pid) return a.pid < b.pid;
+    return a.counter < b.counter;
+}
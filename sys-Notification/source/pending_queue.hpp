@@ -0,0 +1,58 @@
+#pragma once
+
+#include <switch.h>
+
+// 待处理队列配置
+#define PENDING_QUEUE_SIZE  16           // 一次扫描最多收集的文件数（超出的留到下次扫描）
+#define PENDING_NAME_MAX    64           // 文件名最大长度
+
+// 待处理通知文件队列：一次扫描收集目录下全部通知文件（.ini / .ntf），按投递顺序排列
+// 之后取下一个文件和判断是否还有文件都只查队列，不再读目录
+//
+// 文件名为 notif_<系统时钟>_<进程ID>_<进程内计数>.ntf（均为十六进制），
+// 按 (时钟, 进程ID, 计数) 排序即为投递顺序；旧版客户端的随机文件名按修改时间排在前面
+class PendingQueue {
+public:
+    PendingQueue();
+    
+    // 扫描目录重建队列，返回队列中的文件数
+    int Scan(const char* dir_path);
+    
+    // 队首文件的完整路径，队列为空返回 nullptr
+    const char* Front();
+    
+    // 移除队首文件
+    void Pop();
+    
+    bool Empty() const { return m_Head == m_Count; }
+    
+    // 上次扫描没有收集完整（有写入中的临时文件或文件数超出队列），目录无变化也应再扫描
+    bool NeedsRescan() const { return m_Incomplete; }
+    
+private:
+    struct Entry {
+        char name[PENDING_NAME_MAX];
+        bool sequenced;                    // 文件名带投递序号
+        u64 tick;                          // 投递时的系统时钟
+        u64 pid;                           // 投递进程
+        u32 counter;                       // 进程内计数
+        u64 mtime;                         // 修改时间（仅旧版文件名使用）
+    };
+    
+    Entry m_Entries[PENDING_QUEUE_SIZE];   // 按投递顺序排列
+    int m_Head;                            // 队首下标
+    int m_Count;                           // 有效条目数
+    bool m_Incomplete;                     // 上次扫描没有收集完整
+    const char* m_Directory;               // 最近一次扫描的目录
+    char m_PathBuffer[256];                // 完整路径缓冲区
+    
+    // 扫描回调：插入有序位置，队列已满时丢弃最新的
+    static void OnFile(const char* name, void* user);
+    void Insert(const char* name);
+    
+    // 解析 notif_<tick>_<pid>_<counter>.<扩展名>，格式不符返回 false
+    static bool ParseSequencedName(const char* name, Entry* out);
+    
+    // a 是否应排在 b 之前
+    static bool Before(const Entry& a, const Entry& b);
+};
@@ -0,0 +1,162 @@
+#include "spool_journal.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include "util/log.h"
+
+// 文件大小，不存在时为 0
+static u64 FileSize(const char* path) {
+    struct stat st;
+    return (stat(path, &st) == 0) ? (u64)st.st_size : 0;
+}
+
+SpoolJournal::SpoolJournal(const char* path)
+    : m_Path(path), m_RotatedPath{}, m_Rotated(false), m_Offset(0), m_Size(0), m_LiveSize(0)
+    , m_StallOffset(UINT64_MAX), m_StallTick(0), m_Dropped(0), m_PeekCount(0), m_PeekEnd(0), m_RecordEnd{} {
+    snprintf(m_RotatedPath, sizeof(m_RotatedPath), "%s.old", path);
+    
+    // 上次退出时旧日志还没读完，先读旧日志
+    struct stat st;
+    m_Rotated = stat(m_RotatedPath, &st) == 0;
+}
+
+bool SpoolJournal::Refresh() {
+    m_Size = FileSize(CurrentPath());
+    m_LiveSize = m_Rotated ? FileSize(m_Path) : 0;
+    
+    // 文件被删除或被外部清空，从头读
+    if (m_Size < m_Offset) m_Offset = 0;
+    return HasPending();
+}
+
+bool SpoolJournal::IsValid(const u8* data) {
+    NotifSpoolRecord record;
+    memcpy(&record, data, sizeof(record));
+    return record.magic == NOTIF_SPOOL_MAGIC && record.checksum == notif_spool_checksum(&record);
+}
+
+int SpoolJournal::Peek(NotifPostRequest* out, int max) {
+    m_PeekCount = 0;
+    m_PeekEnd = m_Offset;
+    Refresh();
+    
+    // 上次读完后轮转或删除失败（客户端正在写入），再试一次
+    if (m_Size <= m_Offset) {
+        Advance();
+        Refresh();
+        m_PeekEnd = m_Offset;
+        if (m_Size <= m_Offset) return 0;
+    }
+    if (max <= 0) return 0;
+    if (max > SPOOL_READ_RECORDS) max = SPOOL_READ_RECORDS;
+    
+    FILE* file = fopen(CurrentPath(), "rb");
+    if (!file) return 0;
+    
+    u64 want = m_Size - m_Offset;
+    if (want > sizeof(m_Buffer)) want = sizeof(m_Buffer);
+    
+    size_t len = 0;
+    if (fseek(file, (long)m_Offset, SEEK_SET) == 0) len = fread(m_Buffer, 1, want, file);
+    fclose(file);
+    
+    // 读到文件末尾时，最后不足一条的数据可能是正在写入的记录，留到下次
+    const u8* data = (const u8*)m_Buffer;
+    const size_t rec = sizeof(NotifSpoolRecord);
+    bool at_end = m_Offset + len == m_Size;
+    size_t limit = (len >= rec) ? len - rec + 1 : 0;   // 可作为完整记录起点的位置上限
+    size_t pos = 0;
+    int count = 0;
+    
+    while (pos < limit && count < max) {
+        if (IsValid(data + pos)) {
+            NotifSpoolRecord record;
+            memcpy(&record, data + pos, rec);
+            record.request.text[sizeof(record.request.text) - 1] = '\0';
+            pos += rec;
+            if (record.request.text[0] != '\0') {
+                out[count] = record.request;
+                m_RecordEnd[count++] = m_Offset + pos;
+            }
+            continue;
+        }
+        
+        // 坏数据：向后查找下一个 magic（残缺记录之后的记录不一定对齐）
+        u32 magic = NOTIF_SPOOL_MAGIC;
+        size_t next = pos + 1;
+        while (next < len && !(next + sizeof(magic) <= len && memcmp(data + next, &magic, sizeof(magic)) == 0)) next++;
+        
+        // 缓冲区内没有下一个 magic，保留末尾不足一条的数据（可能是下一条记录的开头）
+        if (next >= len) next = limit;
+        m_Dropped += next - pos;
+        pos = next;
+    }
+    u64 end = m_Offset + pos;
+    
+    // 末尾残缺记录：长时间没有写完则丢弃
+    if (at_end && count == 0 && end < m_Size) {
+        u64 now = armGetSystemTick();
+        if (m_StallOffset != end) {
+            m_StallOffset = end;
+            m_StallTick = now;
+        } else if (armTicksToNs(now - m_StallTick) > SPOOL_TORN_NS) {
+            m_Dropped += m_Size - end;
+            end = m_Size;
+        }
+    } else {
+        m_StallOffset = UINT64_MAX;
+    }
+    
+    if (m_Dropped > 0) {
+        log_warning("spool: skipped %u bytes of torn records", m_Dropped);
+        m_Dropped = 0;
+    }
+    
+    m_PeekCount = count;
+    m_PeekEnd = end;
+    return count;
+}
+
+void SpoolJournal::Consume(int count) {
+    // 全部处理完时连同末尾跳过的坏数据一起确认；部分处理时停在下一条未处理记录之前
+    if (count >= m_PeekCount) m_Offset = m_PeekEnd;
+    else if (count > 0) m_Offset = m_RecordEnd[count - 1];
+    m_PeekCount = 0;
+    
+    // 读完立即轮转，退出前不会留下已读的日志（重启后会从头重复读出）
+    if (m_Offset == m_Size) Advance();
+}
+
+void SpoolJournal::Advance() {
+    if (m_Rotated) RemoveRotated();
+    else Rotate();
+}
+
+void SpoolJournal::Rotate() {
+    // 没读过的空日志不轮转
+    if (m_Offset == 0) return;
+    
+    // 改名后客户端的追加写入新文件；客户端正在写入时改名失败，下次再试
+    if (rename(m_Path, m_RotatedPath) != 0) return;
+    
+    // 已读偏移不变：旧日志中已读的部分不会重复读出
+    m_Rotated = true;
+    
+    // 改名前没有新追加的记录：旧日志已读完，直接删除
+    // （改名成功说明没有客户端打开着它，之后也无法再打开）
+    if (FileSize(m_RotatedPath) == m_Offset) RemoveRotated();
+}
+
+void SpoolJournal::RemoveRotated() {
+    if (remove(m_RotatedPath) != 0 && errno != ENOENT) {
+        log_warning("spool: remove %s failed", m_RotatedPath);
+        return;
+    }
+    
+    m_Rotated = false;
+    m_Offset = 0;
+    m_Size = 0;
+    m_LiveSize = 0;
+    m_StallOffset = UINT64_MAX;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <switch.h>
+
+// 只使用 libnotification 的协议定义（日志记录格式）
+#define LIBNOTIFICATION_PROTOCOL_ONLY
+#include "libnotification.h"
+
+// 投递日志配置
+#define SPOOL_READ_RECORDS  8                // 一次读取的记录数
+#define SPOOL_TORN_NS       1000000000ULL    // 末尾不完整的记录超过 1 秒没有写完，视为写入中断
+
+// 追加式投递日志：客户端把定长记录追加到同一个文件，这里记住已读偏移
+// 客户端每条通知只有一次追加写入，没有文件创建、重命名和删除
+//
+// 读完后把日志改名轮转（而不是原地截断）：不持有可写句柄，不会让客户端的追加写入失败
+// 改名前追加的记录留在轮转出去的旧日志中，从已读偏移继续读，读完再删除
+//
+// 写入中断（客户端崩溃、断电）留下的残缺记录按 magic 和校验和识别并跳过：
+// 中间的坏数据向后查找下一个有效记录，末尾不完整的记录等待写完，超时后丢弃
+class SpoolJournal {
+public:
+    explicit SpoolJournal(const char* path);
+    
+    // 读出最多 max 条有效记录但不移动已读偏移，返回条数
+    int Peek(NotifPostRequest* out, int max);
+    
+    // 确认上次 Peek 的前 count 条记录已处理，之后的留到下次读取
+    void Consume(int count);
+    
+    // 上次检查后日志中是否还有未读数据
+    bool HasPending() const { return m_Size > m_Offset || m_LiveSize > 0; }
+    
+    // 重新检查日志大小（不读取），返回是否有未读数据
+    bool Refresh();
+    
+private:
+    const char* m_Path;
+    char m_RotatedPath[64];                // 轮转出去的旧日志（m_Path + ".old"）
+    bool m_Rotated;                        // 正在读旧日志
+    u64 m_Offset;                          // 正在读的文件的已读偏移
+    u64 m_Size;                            // 正在读的文件最近一次检查的大小
+    u64 m_LiveSize;                        // 读旧日志期间当前日志的大小
+    u64 m_StallOffset;                     // 末尾残缺记录的起始偏移
+    u64 m_StallTick;                       // 首次发现末尾残缺记录的时间
+    u32 m_Dropped;                         // 累计跳过的坏数据字节数
+    int m_PeekCount;                       // 上次 Peek 的记录数
+    u64 m_PeekEnd;                         // 上次 Peek 扫描到的位置（含跳过的坏数据）
+    u64 m_RecordEnd[SPOOL_READ_RECORDS];   // 上次 Peek 各条记录的结束偏移
+    NotifSpoolRecord m_Buffer[SPOOL_READ_RECORDS];
+    
+    const char* CurrentPath() const { return m_Rotated ? m_RotatedPath : m_Path; }
+    
+    // 正在读的文件已读完：当前日志改名轮转，旧日志删除
+    void Advance();
+    
+    // 当前日志改名为旧日志，失败（客户端正在写入）时下次再试
+    void Rotate();
+    
+    // 删除旧日志，回到当前日志
+    void RemoveRotated();
+    
+    // 检查 data 处是否为有效记录
+    static bool IsValid(const u8* data);
+};
@@ -0,0 +1,13 @@
+#include "vi_layer_control.hpp"
+
+uint32_t ViLayerControl::SetPosition(float x, float y) {
+    return viSetLayerPosition(m_Layer, x, y);
+}
+
+void ViLayerControl::WaitVsync() {
+    eventWait(m_VsyncEvent, UINT64_MAX);
+}
+
+uint64_t ViLayerControl::GetTimeNs() {
+    return armTicksToNs(armGetSystemTick());
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <switch.h>
+#include "layer_animator.hpp"
+
+// VI 图层实现
+class ViLayerControl : public LayerControl {
+public:
+    ViLayerControl(ViLayer* layer, Event* vsyncEvent) : m_Layer(layer), m_VsyncEvent(vsyncEvent) {}
+    
+    uint32_t SetPosition(float x, float y) override;
+    void WaitVsync() override;
+    uint64_t GetTimeNs() override;
+    
+private:
+    ViLayer* m_Layer;
+    Event* m_VsyncEvent;
+};
@@ -0,0 +1,74 @@
+// 空闲轮询的开销：目录无变化时，变化检测与完整扫描每次调用的耗时（1k / 10k 个通知文件）
+#include "dir_watch.hpp"
+#include "SimpleFs.hpp"
+#include "test_common.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static void CountFile(const char* name, void* user) {
+    (void)name;
+    (*static_cast<int*>(user))++;
+}
+
+// 每次调用的平均耗时（微秒）
+template <typename F>
+static double MeasureUs(int iterations, F&& f) {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; i++) f();
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+}
+
+static void RunCase(int fileCount) {
+    char dir[] = "/tmp/bench_dir_watch_XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        g_TestFailures++;
+        return;
+    }
+    
+    for (int i = 0; i < fileCount; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/notif_%016x_1_0.ntf", dir, i);
+        FILE* f = fopen(path, "wb");
+        if (f) fclose(f);
+    }
+    
+    int iterations = fileCount >= 10000 ? 50 : 500;
+    
+    int found = 0;
+    double scanUs = MeasureUs(iterations, [&] {
+        found = 0;
+        SimpleFs::ScanNotificationFiles(dir, CountFile, &found);
+    });
+    CHECK(found == fileCount);
+    
+    PosixDirChangeDetector detector(dir);
+    CHECK(detector.HasChanged());   // 首次查询总是扫描
+    detector.Commit();
+    
+    bool changed = false;
+    double detectUs = MeasureUs(iterations * 100, [&] { changed |= detector.HasChanged(); });
+    CHECK(!changed);
+    
+    // 新增文件后必须检测到变化
+    std::string added = std::string(dir) + "/notif_ffffffffffffffff_1_0.ntf";
+    FILE* f = fopen(added.c_str(), "wb");
+    if (f) fclose(f);
+    CHECK(detector.HasChanged());
+    
+    printf("%6d files: full scan %10.1f us/poll, change check %6.2f us/poll (%.0fx)\n",
+           fileCount, scanUs, detectUs, scanUs / detectUs);
+    
+    std::string cleanup = std::string("rm -rf ") + dir;
+    if (system(cleanup.c_str()) != 0) g_TestFailures++;
+}
+
+int main() {
+    RunCase(1000);
+    RunCase(10000);
+    return TEST_RESULT();
+}
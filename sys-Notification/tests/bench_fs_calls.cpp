@@ -0,0 +1,111 @@
+// 文件系统调用次数：空闲轮询、一次目录扫描、每条文件通知（读取 + 删除）各调用多少次文件系统
+// 编译两次：bench_fs_calls 用 POSIX 后端，统计进入 newlib/fsdev 的 libc 文件调用（链接时 --wrap）；
+// bench_fs_calls_native 用 Switch 原生后端，统计 fs 函数调用，真机上每次是一次 IPC（host/fs_stub.cpp）
+#include "dir_watch.hpp"
+#include "pending_queue.hpp"
+#include "SimpleFs.hpp"
+#include "test_common.hpp"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <cstdlib>
+#include <string>
+
+#if SIMPLEFS_NATIVE
+#define BACKEND "native"
+#define UNIT    "fs IPC"
+static unsigned& s_Calls = g_HostFsCalls;
+#else
+#define BACKEND "posix"
+#define UNIT    "libc call"
+static unsigned s_Calls = 0;
+
+// 统计 POSIX 后端用到的 libc 文件函数（在真机上每个都经过 fsdev，至少一次 IPC；readdir 由 fsdev 批量读取）
+extern "C" {
+DIR* __real_opendir(const char* path);
+struct dirent* __real_readdir(DIR* dir);
+int __real_closedir(DIR* dir);
+FILE* __real_fopen(const char* path, const char* mode);
+int __real_fseek(FILE* file, long offset, int whence);
+long __real_ftell(FILE* file);
+size_t __real_fread(void* buf, size_t size, size_t count, FILE* file);
+int __real_fclose(FILE* file);
+int __real_stat(const char* path, struct stat* st);
+int __real_remove(const char* path);
+
+DIR* __wrap_opendir(const char* path) { s_Calls++; return __real_opendir(path); }
+struct dirent* __wrap_readdir(DIR* dir) { s_Calls++; return __real_readdir(dir); }
+int __wrap_closedir(DIR* dir) { s_Calls++; return __real_closedir(dir); }
+FILE* __wrap_fopen(const char* path, const char* mode) { s_Calls++; return __real_fopen(path, mode); }
+int __wrap_fseek(FILE* file, long offset, int whence) { s_Calls++; return __real_fseek(file, offset, whence); }
+long __wrap_ftell(FILE* file) { s_Calls++; return __real_ftell(file); }
+size_t __wrap_fread(void* buf, size_t size, size_t count, FILE* file) { s_Calls++; return __real_fread(buf, size, count, file); }
+int __wrap_fclose(FILE* file) { s_Calls++; return __real_fclose(file); }
+int __wrap_stat(const char* path, struct stat* st) { s_Calls++; return __real_stat(path, st); }
+int __wrap_remove(const char* path) { s_Calls++; return __real_remove(path); }
+}
+#endif
+
+// 写入 count 个带序号的通知记录（每个 48 字节）
+static void WriteNotifications(const char* dir, int count) {
+    char record[48] = "notification";
+    for (int i = 0; i < count; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/notif_%016x_1_0.ntf", dir, i);
+        FILE* f = fopen(path, "wb");
+        if (!f) continue;
+        fwrite(record, sizeof(record), 1, f);
+        fclose(f);
+    }
+}
+
+static void RunCase(int fileCount) {
+    char dir[] = "/tmp/bench_fs_calls_XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        g_TestFailures++;
+        return;
+    }
+    WriteNotifications(dir, fileCount);
+
+    DefaultDirChangeDetector detector(dir);
+    detector.HasChanged();
+    detector.Commit();
+
+    // 空闲轮询：目录没有变化
+    unsigned start = s_Calls;
+    CHECK(!detector.HasChanged());
+    unsigned pollCalls = s_Calls - start;
+
+    // 一次目录扫描（收集全部通知文件）
+    PendingQueue queue;
+    start = s_Calls;
+    int queued = queue.Scan(dir);
+    unsigned scanCalls = s_Calls - start;
+    CHECK(queued == (fileCount < PENDING_QUEUE_SIZE ? fileCount : PENDING_QUEUE_SIZE));
+
+    // 逐条投递：读取内容后删除
+    start = s_Calls;
+    int delivered = 0;
+    while (const char* file = queue.Front()) {
+        size_t size = 0;
+        CHECK(SimpleFs::ReadFileContent(file, &size) != nullptr && size == 48);
+        CHECK(SimpleFs::DeleteFile(file));
+        queue.Pop();
+        delivered++;
+    }
+    unsigned deliverCalls = s_Calls - start;
+    CHECK(delivered == queued);
+
+    printf("%-6s %3d files: idle poll %3u, scan %4u, per notification %.1f %ss\n",
+           BACKEND, fileCount, pollCalls, scanCalls, delivered ? (double)deliverCalls / delivered : 0.0, UNIT);
+
+    std::string cleanup = std::string("rm -rf ") + dir;
+    if (system(cleanup.c_str()) != 0) g_TestFailures++;
+}
+
+int main() {
+    RunCase(1);
+    RunCase(16);
+    RunCase(64);
+    return TEST_RESULT();
+}
@@ -0,0 +1,134 @@
+// 字形绘制吞吐（每秒混合的字形位图像素）：改动前的逐像素 SetPixelBlend 与 DrawTextLayout 对比
+//   逐像素：每个字形像素换算 alpha 后单独混合（查找表之前的做法）
+//   逐字形：覆盖率查找表 + 按行批量混合
+//   遮罩：整段文本一张覆盖率遮罩，每次绘制只混合一次
+// 块线性帧缓冲和线性表面分别计时；需要 NOTIF_TEST_FONT=<ttf 路径>，未设置时跳过
+#include "graphics.hpp"
+#include "font_manager.hpp"
+#include "test_common.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#define FB_W 416
+#define FB_H 100
+#define FB_ALLOC_H 128
+#define DRAWS 5000
+
+#define BENCH_TEXT       "Notification benchmark 0123456"
+#define BENCH_FONT_SIZE  28
+
+typedef std::chrono::steady_clock Clock;
+
+static u16 s_Framebuffer[FB_W * FB_ALLOC_H];
+static u16 s_Linear[FB_W * FB_H];
+static u16 s_Reference[FB_W * FB_ALLOC_H];
+
+// 改动前的字形绘制：覆盖率换算为 4 位 alpha，逐像素混合
+static void DrawPerPixel(GraphicsRenderer& g, const TextLayout& layout, Color color) {
+    FontManager& fontMgr = FontManager::Instance();
+    for (u32 i = 0; i < layout.count; i++) {
+        const TextLayout::Glyph& glyph = layout.glyphs[i];
+        auto bitmap = fontMgr.RenderGlyph(glyph.font, glyph.glyphIndex, layout.fontSize);
+        if (!bitmap.data) continue;
+        
+        s32 glyphX = glyph.penX + bitmap.xoffset;
+        s32 glyphY = layout.baselineY + bitmap.yoffset;
+        for (s32 py = 0; py < bitmap.height; py++) {
+            for (s32 px = 0; px < bitmap.width; px++) {
+                s32 x = glyphX + px, y = glyphY + py;
+                if (x < layout.x || x >= layout.x + layout.w || y < layout.y || y >= layout.y + layout.h) continue;
+                
+                u8 coverage = bitmap.data[py * bitmap.width + px];
+                if (coverage == 0) continue;
+                u8 a = (u8)((coverage / 17) * color.a / 15);
+                if (a == 0) continue;
+                g.SetPixelBlend(x, y, {color.r, color.g, color.b, a});
+            }
+        }
+        fontMgr.FreeGlyph(bitmap);
+    }
+}
+
+// 每次绘制混合的字形位图像素数（裁剪到文本框之前）
+static u64 GlyphPixels(const TextLayout& layout) {
+    FontManager& fontMgr = FontManager::Instance();
+    u64 pixels = 0;
+    for (u32 i = 0; i < layout.count; i++) {
+        auto bitmap = fontMgr.RenderGlyph(layout.glyphs[i].font, layout.glyphs[i].glyphIndex, layout.fontSize);
+        pixels += (u64)bitmap.width * bitmap.height;
+        fontMgr.FreeGlyph(bitmap);
+    }
+    return pixels;
+}
+
+template <typename Draw>
+static double MeasurePixelsPerSecond(GraphicsRenderer& g, bool linear, u64 pixels, Draw draw) {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < DRAWS; i++) {
+        if (linear) g.StartOffscreen();
+        else g.StartFrame();
+        draw();
+        if (linear) g.EndOffscreen();
+        else g.EndFrame();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return pixels * DRAWS / seconds;
+}
+
+static void RunTarget(GraphicsRenderer& g, TextLayout& layout, bool linear, u64 pixels) {
+    const Color color = {5, 5, 5, 15};
+    u16* target = linear ? s_Linear : s_Framebuffer;
+    size_t size = linear ? sizeof(s_Linear) : sizeof(s_Framebuffer);
+    
+    // 单次绘制结果一致：逐像素与逐字形、遮罩（字形不重叠）
+    memset(target, 0, size);
+    if (linear) g.StartOffscreen(); else g.StartFrame();
+    DrawPerPixel(g, layout, color);
+    if (linear) g.EndOffscreen(); else g.EndFrame();
+    memcpy(s_Reference, target, size);
+    
+    memset(target, 0, size);
+    if (linear) g.StartOffscreen(); else g.StartFrame();
+    g.DrawTextLayout(layout, 0, 0, color);
+    if (linear) g.EndOffscreen(); else g.EndFrame();
+    CHECK(memcmp(s_Reference, target, size) == 0);
+    
+    double perPixel = MeasurePixelsPerSecond(g, linear, pixels, [&] { DrawPerPixel(g, layout, color); });
+    double perGlyph = MeasurePixelsPerSecond(g, linear, pixels, [&] { g.DrawTextLayout(layout, 0, 0, color); });
+    
+    double masked = 0;
+    if (g.BuildTextMask(layout)) {
+        masked = MeasurePixelsPerSecond(g, linear, pixels, [&] { g.DrawTextLayout(layout, 0, 0, color); });
+        GraphicsRenderer::FreeTextMask(layout);
+    }
+    
+    printf("  %-12s per-pixel %7.1f Mpx/s, per-glyph %7.1f Mpx/s (%.2fx), mask %7.1f Mpx/s (%.2fx)\n",
+           linear ? "linear:" : "block-linear:", perPixel / 1e6, perGlyph / 1e6, perGlyph / perPixel,
+           masked / 1e6, masked / perPixel);
+}
+
+int main() {
+    if (!getenv("NOTIF_TEST_FONT")) {
+        printf("bench_glyph_blit: skipped (NOTIF_TEST_FONT not set)\n");
+        return 0;
+    }
+    
+    static Framebuffer fb;
+    static Event vsync;
+    GraphicsRenderer g;
+    g.Bind(&fb, &vsync, FB_W, FB_H);
+    g.BindLinearSurface(s_Linear);
+    g_HostFramebuffer = s_Framebuffer;
+    
+    static TextLayout layout;
+    g.LayoutText(layout, BENCH_TEXT, 0, 0, FB_W, FB_H, BENCH_FONT_SIZE, GraphicsRenderer::TextAlign::LEFT);
+    CHECK(layout.count > 0);
+    u64 pixels = GlyphPixels(layout);
+    
+    printf("%u glyphs at %d px, %llu glyph pixels per draw, %d draws:\n",
+           layout.count, BENCH_FONT_SIZE, (unsigned long long)pixels, DRAWS);
+    RunTarget(g, layout, false, pixels);
+    RunTarget(g, layout, true, pixels);
+    return TEST_RESULT();
+}
@@ -0,0 +1,111 @@
+// 系统模块未运行时的投递开销：每条通知一个文件（写临时文件 + 重命名，模块扫描、读取、删除）
+// 与投递日志（一次追加写入，模块批量读取、读完轮转）对比，客户端和模块两侧分别计时
+#include "pending_queue.hpp"
+#include "spool_journal.hpp"
+#include "SimpleFs.hpp"
+#include "test_common.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+#define NOTIFICATIONS 2000
+
+typedef std::chrono::steady_clock Clock;
+
+static double ElapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+static NotifPostRequest MakeRequest(int i) {
+    NotifPostRequest request;
+    memset(&request, 0, sizeof(request));
+    snprintf(request.text, sizeof(request.text), "Notification %d", i);
+    request.duration = 3;
+    return request;
+}
+
+// 客户端的文件投递路径：写 .ntf.temp，关闭后重命名（与 _notif_create 相同的系统调用）
+static bool PostFile(const std::string& dir, int i) {
+    NotifPostRequest request = MakeRequest(i);
+    char temp[256];
+    snprintf(temp, sizeof(temp), "%s/notif_%016x_1_0.ntf.temp", dir.c_str(), i);
+    
+    FILE* f = fopen(temp, "wb");
+    if (!f) return false;
+    bool ok = fwrite(&request, sizeof(request), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    
+    std::string final_path(temp, strlen(temp) - 5);
+    return ok && rename(temp, final_path.c_str()) == 0;
+}
+
+// 客户端的日志投递路径：一次不缓冲的追加写入（与 _notif_spool_post 相同）
+static bool PostSpool(const std::string& path, int i) {
+    NotifSpoolRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = NOTIF_SPOOL_MAGIC;
+    record.tick = i;
+    record.request = MakeRequest(i);
+    record.checksum = notif_spool_checksum(&record);
+    
+    FILE* f = fopen(path.c_str(), "ab");
+    if (!f) return false;
+    setvbuf(f, NULL, _IONBF, 0);
+    bool ok = fwrite(&record, sizeof(record), 1, f) == 1;
+    return (fclose(f) == 0) && ok;
+}
+
+int main() {
+    char dir[] = "/tmp/bench_spool_XXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    std::string base = dir;
+    
+    // 1. 每条通知一个文件
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < NOTIFICATIONS; i++) CHECK(PostFile(base, i));
+    double fileClientUs = ElapsedUs(start);
+    
+    start = Clock::now();
+    PendingQueue pending;
+    int fileCount = 0;
+    while (pending.Scan(base.c_str()) > 0) {
+        while (const char* file = pending.Front()) {
+            size_t size = 0;
+            if (SimpleFs::ReadFileContent(file, &size)) fileCount++;
+            SimpleFs::DeleteFile(file);
+            pending.Pop();
+        }
+    }
+    double fileModuleUs = ElapsedUs(start);
+    CHECK(fileCount == NOTIFICATIONS);
+    
+    // 2. 投递日志（模块按主循环的方式一次取半个请求队列）
+    std::string spoolPath = base + "/spool.bin";
+    start = Clock::now();
+    for (int i = 0; i < NOTIFICATIONS; i++) CHECK(PostSpool(spoolPath, i));
+    double spoolClientUs = ElapsedUs(start);
+    
+    start = Clock::now();
+    SpoolJournal spool(spoolPath.c_str());
+    NotifPostRequest records[SPOOL_READ_RECORDS];
+    int spoolCount = 0;
+    while (spool.Refresh()) {
+        int count = spool.Peek(records, SPOOL_READ_RECORDS);
+        spool.Consume(count);
+        spoolCount += count;
+    }
+    double spoolModuleUs = ElapsedUs(start);
+    CHECK(spoolCount == NOTIFICATIONS);
+    
+    printf("%d notifications (host /tmp, per notification):\n", NOTIFICATIONS);
+    printf("  file per notification: client %7.2f us, module %7.2f us\n",
+           fileClientUs / NOTIFICATIONS, fileModuleUs / NOTIFICATIONS);
+    printf("  spool journal:         client %7.2f us, module %7.2f us\n",
+           spoolClientUs / NOTIFICATIONS, spoolModuleUs / NOTIFICATIONS);
+    
+    std::string cleanup = "rm -rf " + base;
+    if (system(cleanup.c_str()) != 0) g_TestFailures++;
+    return TEST_RESULT();
+}
@@ -0,0 +1,123 @@
+// 主机测试用的 SD 卡文件系统：用 POSIX 实现 SimpleFsNative 和原生目录变化检测用到的 fs 函数
+// 每个 fs 函数在真机上是一次 IPC，这里每次调用计入 g_HostFsCalls
+#include <switch.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+unsigned g_HostFsCalls = 0;
+
+static FsFileSystem s_Sdmc;
+
+// 只列出普通文件（SimpleFs 和目录变化检测都以 ReadFiles 模式打开目录）
+static bool NextFile(DIR* dir, struct dirent** out) {
+    while (struct dirent* e = readdir(dir)) {
+        if (e->d_type == DT_REG) {
+            *out = e;
+            return true;
+        }
+    }
+    return false;
+}
+
+extern "C" {
+
+FsFileSystem* fsdevGetDeviceFileSystem(const char*) {
+    return &s_Sdmc;
+}
+
+Result fsFsOpenDirectory(FsFileSystem*, const char* path, u32, FsDir* out) {
+    g_HostFsCalls++;
+    out->dir = opendir(path);
+    return out->dir ? 0 : 1;
+}
+
+Result fsDirRead(FsDir* d, s64* total_entries, size_t max_entries, FsDirectoryEntry* buf) {
+    g_HostFsCalls++;
+    s64 count = 0;
+    struct dirent* e;
+    while ((size_t)count < max_entries && NextFile((DIR*)d->dir, &e)) {
+        memset(&buf[count], 0, sizeof(buf[count]));
+        strncpy(buf[count].name, e->d_name, sizeof(buf[count].name) - 1);
+        buf[count].type = FsDirEntryType_File;
+        count++;
+    }
+    *total_entries = count;
+    return 0;
+}
+
+Result fsDirGetEntryCount(FsDir* d, s64* count) {
+    g_HostFsCalls++;
+    DIR* dir = (DIR*)d->dir;
+    long pos = telldir(dir);
+    rewinddir(dir);
+    struct dirent* e;
+    *count = 0;
+    while (NextFile(dir, &e)) (*count)++;
+    seekdir(dir, pos);
+    return 0;
+}
+
+void fsDirClose(FsDir* d) {
+    g_HostFsCalls++;
+    closedir((DIR*)d->dir);
+}
+
+Result fsFsOpenFile(FsFileSystem*, const char* path, u32, FsFile* out) {
+    g_HostFsCalls++;
+    out->fd = open(path, O_RDONLY);
+    return out->fd >= 0 ? 0 : 1;
+}
+
+Result fsFileGetSize(FsFile* f, s64* out) {
+    g_HostFsCalls++;
+    struct stat st;
+    if (fstat(f->fd, &st) != 0) return 1;
+    *out = st.st_size;
+    return 0;
+}
+
+Result fsFileRead(FsFile* f, s64 off, void* buf, u64 read_size, u32, u64* bytes_read) {
+    g_HostFsCalls++;
+    ssize_t n = pread(f->fd, buf, read_size, off);
+    if (n < 0) return 1;
+    *bytes_read = (u64)n;
+    return 0;
+}
+
+void fsFileClose(FsFile* f) {
+    g_HostFsCalls++;
+    close(f->fd);
+}
+
+Result fsFsDeleteFile(FsFileSystem*, const char* path) {
+    g_HostFsCalls++;
+    return unlink(path) == 0 ? 0 : 1;
+}
+
+Result fsFsCreateDirectory(FsFileSystem*, const char* path) {
+    g_HostFsCalls++;
+    return mkdir(path, 0755) == 0 ? 0 : 1;
+}
+
+Result fsFsGetEntryType(FsFileSystem*, const char* path, FsDirEntryType* out) {
+    g_HostFsCalls++;
+    struct stat st;
+    if (stat(path, &st) != 0) return 1;
+    *out = S_ISDIR(st.st_mode) ? FsDirEntryType_Dir : FsDirEntryType_File;
+    return 0;
+}
+
+Result fsFsGetFileTimeStampRaw(FsFileSystem*, const char* path, FsTimeStampRaw* out) {
+    g_HostFsCalls++;
+    struct stat st;
+    memset(out, 0, sizeof(*out));
+    if (stat(path, &st) != 0) return 1;
+    out->modified = (u64)st.st_mtime;
+    out->is_valid = 1;
+    return 0;
+}
+
+}
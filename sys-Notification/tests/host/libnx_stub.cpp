@@ -0,0 +1,173 @@
+// 主机测试用的 libnx 函数实现
+#include <switch.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+void* g_HostFramebuffer = nullptr;
+
+// 环境变量 NOTIF_TEST_FONT 指定的 TTF 作为标准共享字体（未设置时没有字体）
+static u8* LoadTestFont() {
+    static u8* data = nullptr;
+    if (data) return data;
+    
+    const char* path = getenv("NOTIF_TEST_FONT");
+    if (!path) return nullptr;
+    
+    FILE* file = fopen(path, "rb");
+    if (!file) return nullptr;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    data = (u8*)malloc(size);
+    if (data && fread(data, 1, size, file) != (size_t)size) {
+        free(data);
+        data = nullptr;
+    }
+    fclose(file);
+    return data;
+}
+
+extern "C" {
+
+void* framebufferBegin(Framebuffer*, u32* out_stride) {
+    if (out_stride) *out_stride = 0;
+    return g_HostFramebuffer;
+}
+
+void framebufferEnd(Framebuffer*) {
+}
+
+Result eventWait(Event*, u64) {
+    return 0;
+}
+
+// 系统时钟 19.2MHz，用主机单调时钟换算
+u64 armGetSystemTick(void) {
+    u64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return ns * 12 / 625;
+}
+
+u64 armTicksToNs(u64 ticks) {
+    return ticks * 625 / 12;
+}
+
+u64 armNsToTicks(u64 ns) {
+    return ns * 12 / 625;
+}
+
+Result plGetSharedFontByType(PlFontData* font, PlSharedFontType type) {
+    u8* data = (type == PlSharedFontType_Standard) ? LoadTestFont() : nullptr;
+    if (!data) return 1;
+    
+    font->type = type;
+    font->offset = 0;
+    font->size = 0;
+    font->address = data;
+    return 0;
+}
+
+Result setGetSystemLanguage(u64*) {
+    return 1;
+}
+
+void mutexLock(Mutex* m) {
+    pthread_mutex_lock(m);
+}
+
+void mutexUnlock(Mutex* m) {
+    pthread_mutex_unlock(m);
+}
+
+Result condvarWait(CondVar* c, Mutex* m) {
+    return pthread_cond_wait(c, m);
+}
+
+Result condvarWakeOne(CondVar* c) {
+    return pthread_cond_signal(c);
+}
+
+static void* ThreadTrampoline(void* arg) {
+    Thread* t = (Thread*)arg;
+    t->entry(t->arg);
+    return nullptr;
+}
+
+// 栈、优先级和核心由主机调度，忽略
+Result threadCreate(Thread* t, ThreadFunc entry, void* arg, void*, size_t, int, int) {
+    t->entry = entry;
+    t->arg = arg;
+    return 0;
+}
+
+Result threadStart(Thread* t) {
+    return pthread_create(&t->pthread, nullptr, ThreadTrampoline, t);
+}
+
+Result threadWaitForExit(Thread* t) {
+    return pthread_join(t->pthread, nullptr);
+}
+
+Result threadClose(Thread*) {
+    return 0;
+}
+
+Result svcGetThreadPriority(s32* priority, Handle) {
+    *priority = 0x2C;
+    return 0;
+}
+
+Result svcGetProcessId(u64* process_id, Handle) {
+    *process_id = (u64)getpid();
+    return 0;
+}
+
+Result pmdmntGetProcessId(u64*, u64) {
+    return 1;
+}
+
+Result pmshellLaunchProgram(u32, const NcmProgramLocation*, u64*) {
+    return 1;
+}
+
+Result svcConnectToNamedPort(Handle*, const char*) {
+    return 1;
+}
+
+void serviceCreate(Service* s, Handle h) {
+    s->session = h;
+}
+
+void serviceClose(Service*) {
+}
+
+Result shmemLoadRemote(SharedMemory* s, Handle handle, size_t size, Permission) {
+    s->handle = handle;
+    s->size = size;
+    s->map_addr = nullptr;
+    return 0;
+}
+
+Result shmemMap(SharedMemory*) {
+    return 1;
+}
+
+Result shmemClose(SharedMemory*) {
+    return 0;
+}
+
+void* shmemGetAddr(SharedMemory* s) {
+    return s->map_addr;
+}
+
+Result svcCloseHandle(Handle) {
+    return 0;
+}
+
+Result svcSignalEvent(Handle) {
+    return 0;
+}
+
+}
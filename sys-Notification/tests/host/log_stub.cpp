@@ -0,0 +1,27 @@
+// 主机测试用的日志实现：设置环境变量 NOTIF_TEST_LOG 时输出到 stderr（模块中写入 SD 卡上的日志文件）
+#include "util/log.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+static void LogWrite(const char* level, const char* file, int line, const char* fmt, va_list args) {
+    static const bool enabled = getenv("NOTIF_TEST_LOG") != nullptr;
+    if (!enabled) return;
+    
+    fprintf(stderr, "[%s:%d] [%s] ", file, line, level);
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+}
+
+#define LOG_IMPL(name, level) \
+    void name(const char* file, int line, const char* fmt, ...) { \
+        va_list args; \
+        va_start(args, fmt); \
+        LogWrite(level, file, line, fmt, args); \
+        va_end(args); \
+    }
+
+LOG_IMPL(log_info_impl, "INFO")
+LOG_IMPL(log_warning_impl, "WARNING")
+LOG_IMPL(log_error_impl, "ERROR")
+LOG_IMPL(log_debug_impl, "DEBUG")
@@ -0,0 +1,131 @@
+// 主机测试用的 libnx 替身：只声明被测代码用到的类型和函数
+// 函数实现见 libnx_stub.cpp（帧缓冲、字体等返回测试可控的结果，线程和锁用 pthread 实现）
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t   s8;
+typedef int16_t  s16;
+typedef int32_t  s32;
+typedef int64_t  s64;
+
+typedef u32 Result;
+typedef u32 Handle;
+
+#define R_SUCCEEDED(res) ((res) == 0)
+#define R_FAILED(res)    ((res) != 0)
+
+#define CUR_PROCESS_HANDLE 0xFFFF8001
+#define CUR_THREAD_HANDLE  0xFFFF8000
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct { Handle revent; Handle wevent; bool autoclear; } Event;
+typedef struct { u32 width, height; } Framebuffer;
+
+typedef struct { u32 type, offset, size; void* address; } PlFontData;
+typedef enum {
+    PlSharedFontType_Standard = 0,
+    PlSharedFontType_ChineseSimplified = 1,
+    PlSharedFontType_ExtChineseSimplified = 2,
+    PlSharedFontType_ChineseTraditional = 3,
+    PlSharedFontType_KO = 4,
+    PlSharedFontType_NintendoExt = 5,
+    PlSharedFontType_Total,
+} PlSharedFontType;
+
+void* framebufferBegin(Framebuffer* fb, u32* out_stride);
+void framebufferEnd(Framebuffer* fb);
+Result eventWait(Event* e, u64 timeout);
+
+u64 armGetSystemTick(void);
+u64 armTicksToNs(u64 ticks);
+u64 armNsToTicks(u64 ns);
+
+Result plGetSharedFontByType(PlFontData* font, PlSharedFontType type);
+Result setGetSystemLanguage(u64* out);
+
+// 同步原语：零初始化即可使用（与 libnx 相同）
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t CondVar;
+
+void mutexLock(Mutex* m);
+void mutexUnlock(Mutex* m);
+Result condvarWait(CondVar* c, Mutex* m);
+Result condvarWakeOne(CondVar* c);
+
+typedef void (*ThreadFunc)(void*);
+typedef struct { pthread_t pthread; ThreadFunc entry; void* arg; } Thread;
+
+Result threadCreate(Thread* t, ThreadFunc entry, void* arg, void* stack_mem, size_t stack_sz, int prio, int cpuid);
+Result threadStart(Thread* t);
+Result threadWaitForExit(Thread* t);
+Result threadClose(Thread* t);
+Result svcGetThreadPriority(s32* priority, Handle handle);
+Result svcGetProcessId(u64* process_id, Handle handle);
+
+// 系统模块服务：主机上没有系统模块，查询和连接都失败，客户端走文件投递
+typedef enum { NcmStorageId_None = 0 } NcmStorageId;
+typedef struct { u64 program_id; u8 storageID; } NcmProgramLocation;
+typedef struct { Handle session; } Service;
+typedef struct { Handle handle; size_t size; void* map_addr; } SharedMemory;
+typedef enum { Perm_Rw = 3 } Permission;
+
+Result pmdmntGetProcessId(u64* pid_out, u64 program_id);
+Result pmshellLaunchProgram(u32 launch_flags, const NcmProgramLocation* location, u64* pid);
+Result svcConnectToNamedPort(Handle* session, const char* name);
+void serviceCreate(Service* s, Handle h);
+void serviceClose(Service* s);
+#define serviceDispatch(s, id, ...)        ((Result)1)
+#define serviceDispatchIn(s, id, in, ...)  ((Result)1)
+Result shmemLoadRemote(SharedMemory* s, Handle handle, size_t size, Permission perm);
+Result shmemMap(SharedMemory* s);
+Result shmemClose(SharedMemory* s);
+void* shmemGetAddr(SharedMemory* s);
+Result svcCloseHandle(Handle handle);
+Result svcSignalEvent(Handle handle);
+
+// SD 卡文件系统（fs_stub.cpp 用 POSIX 实现，只列出普通文件）
+#define FS_MAX_PATH 0x301
+#define Module_Fs   2
+#define MAKERESULT(module, description) ((((module) & 0x1FF)) | ((description) & 0x1FFF) << 9)
+#define R_VALUE(res) ((res) & 0x3FFFFF)
+
+typedef struct { int unused; } FsFileSystem;
+typedef struct { void* dir; } FsDir;
+typedef struct { int fd; } FsFile;
+typedef enum { FsDirEntryType_Dir = 0, FsDirEntryType_File = 1 } FsDirEntryType;
+typedef struct { char name[FS_MAX_PATH]; u8 pad[3]; s8 type; u8 pad2[3]; s64 file_size; } FsDirectoryEntry;
+typedef struct { u64 created, modified, accessed; u8 is_valid; u8 padding[7]; } FsTimeStampRaw;
+
+#define FsDirOpenMode_ReadFiles  (1U << 1)
+#define FsDirOpenMode_NoFileSize (1U << 31)
+#define FsOpenMode_Read          (1U << 0)
+#define FsReadOption_None        0
+
+FsFileSystem* fsdevGetDeviceFileSystem(const char* name);
+Result fsFsOpenDirectory(FsFileSystem* fs, const char* path, u32 mode, FsDir* out);
+Result fsDirRead(FsDir* d, s64* total_entries, size_t max_entries, FsDirectoryEntry* buf);
+Result fsDirGetEntryCount(FsDir* d, s64* count);
+void fsDirClose(FsDir* d);
+Result fsFsOpenFile(FsFileSystem* fs, const char* path, u32 mode, FsFile* out);
+Result fsFileGetSize(FsFile* f, s64* out);
+Result fsFileRead(FsFile* f, s64 off, void* buf, u64 read_size, u32 option, u64* bytes_read);
+void fsFileClose(FsFile* f);
+Result fsFsDeleteFile(FsFileSystem* fs, const char* path);
+Result fsFsCreateDirectory(FsFileSystem* fs, const char* path);
+Result fsFsGetEntryType(FsFileSystem* fs, const char* path, FsDirEntryType* out);
+Result fsFsGetFileTimeStampRaw(FsFileSystem* fs, const char* path, FsTimeStampRaw* out);
+
+#ifdef __cplusplus
+}
+#endif
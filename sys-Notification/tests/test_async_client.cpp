@@ -0,0 +1,128 @@
+// libnotification 异步投递的多线程测试（主机上用 pthread 代替 libnx 线程，建议用 make tsan 运行）
+// 两个源文件直接包含头文件（不定义 LIBNOTIFICATION_IMPLEMENTATION）同时投递，
+// 检查库状态只有一份、每条入队的通知恰好回调一次、flush 与投递并发时不丢失回调
+#include <switch.h>
+#include "libnotification.h"
+#include "test_common.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define PRODUCERS       4
+#define POSTS_EACH      2000
+#define FLUSH_ROUNDS    50
+
+// 主机上没有系统模块文件，投递在检查模块文件时返回
+#define HOST_RESULT     ((Result)-5)
+
+const void* PeerAsyncQueue();
+const void* PeerLock();
+const void* PeerRingClient();
+bool PeerSpoolMode();
+Result PeerPostAsync(const char* text, NotifCompletionCallback callback, void* user);
+Result PeerPost(const char* text);
+
+struct Counter {
+    std::atomic<int> calls{0};
+    std::atomic<int> wrong{0};
+};
+
+static void CountCallback(Result rc, void* user) {
+    Counter* counter = (Counter*)user;
+    if (rc != HOST_RESULT) counter->wrong++;
+    counter->calls++;
+}
+
+// 入队直到成功，队列已满时让出 CPU 重试
+static Result PostUntilQueued(bool peer, Counter* counter) {
+    while (true) {
+        Result rc = peer ? PeerPostAsync("async", CountCallback, counter)
+                         : createNotificationAsync("async", 3, INFO, RIGHT, CountCallback, counter);
+        if (rc != (Result)-9) return rc;
+        std::this_thread::yield();
+    }
+}
+
+static void TestSingleDefinition() {
+    CHECK(PeerAsyncQueue() == &_notif_async_queue);
+    CHECK(PeerLock() == &_notif_mutex);
+    CHECK(PeerRingClient() == &_notif_ring_client);
+    
+    notifSetSpoolMode(true);
+    CHECK(PeerSpoolMode());
+    notifSetSpoolMode(false);
+    CHECK(!PeerSpoolMode());
+}
+
+// 两个源文件的多个线程同时入队，另一个线程同步投递，flush 后每条都已回调
+static void TestConcurrentPosts() {
+    Counter counters[PRODUCERS];
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([p, &counters] {
+            for (int i = 0; i < POSTS_EACH; i++) CHECK(PostUntilQueued(p % 2 == 1, &counters[p]) == 0);
+        });
+    }
+    std::thread sync([&done] {
+        while (!done.load()) CHECK(PeerPost("sync") == HOST_RESULT);
+    });
+    
+    for (auto& t : threads) t.join();
+    notifAsyncFlush();
+    done = true;
+    sync.join();
+    
+    for (int p = 0; p < PRODUCERS; p++) {
+        CHECK(counters[p].calls.load() == POSTS_EACH);
+        CHECK(counters[p].wrong.load() == 0);
+    }
+    CHECK(_notif_async_queue.count == 0);
+    CHECK(!_notif_async_queue.running);
+}
+
+// flush 期间的投递返回 -10，之后的投递重新创建工作线程；入队成功的通知都会回调
+static void TestFlushWhilePosting() {
+    Counter counter;
+    std::atomic<int> queued{0};
+    std::atomic<bool> done{false};
+    
+    std::thread producer([&] {
+        while (!done.load()) {
+            Result rc = PeerPostAsync("async", CountCallback, &counter);
+            if (rc == 0) queued++;
+            else CHECK(rc == (Result)-9 || rc == (Result)-10);
+        }
+    });
+    
+    for (int i = 0; i < FLUSH_ROUNDS; i++) {
+        std::this_thread::yield();
+        notifAsyncFlush();
+    }
+    done = true;
+    producer.join();
+    notifAsyncFlush();
+    
+    CHECK(counter.calls.load() == queued.load());
+    CHECK(counter.wrong.load() == 0);
+}
+
+static void TestStatusCallback() {
+    NotifAsyncStatus status = {};
+    CHECK(createNotificationAsync("status", 3, INFO, RIGHT, notifAsyncStatusCallback, &status) == 0);
+    notifAsyncFlush();
+    CHECK(notifAsyncStatusDone(&status));
+    CHECK(status.rc == HOST_RESULT);
+    
+    CHECK(createNotificationAsync("", 3, INFO, RIGHT, nullptr, nullptr) == (Result)-1);
+    CHECK(createNotificationAsync(nullptr, 3, INFO, RIGHT, nullptr, nullptr) == (Result)-1);
+}
+
+int main() {
+    TestSingleDefinition();
+    TestConcurrentPosts();
+    TestFlushWhilePosting();
+    TestStatusCallback();
+    return TEST_RESULT();
+}
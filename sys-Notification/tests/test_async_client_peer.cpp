@@ -0,0 +1,27 @@
+// test_async_client 的第二个源文件：检查两个源文件中的弱符号链接后是同一份库状态
+#include <switch.h>
+#include "libnotification.h"
+
+const void* PeerAsyncQueue() {
+    return &_notif_async_queue;
+}
+
+const void* PeerLock() {
+    return &_notif_mutex;
+}
+
+const void* PeerRingClient() {
+    return &_notif_ring_client;
+}
+
+bool PeerSpoolMode() {
+    return _notif_spool_enabled;
+}
+
+Result PeerPostAsync(const char* text, NotifCompletionCallback callback, void* user) {
+    return createNotificationAsync(text, 3, INFO, RIGHT, callback, user);
+}
+
+Result PeerPost(const char* text) {
+    return createNotification(text, 3, INFO, RIGHT);
+}
@@ -0,0 +1,115 @@
+// blend4444 穷举测试：所有 16x16x16 的通道组合（前景值、背景值、alpha）与整数除法截断比较，
+// alpha 的所有 16x16 组合检查饱和；行混合覆盖 8 像素一组的路径和尾部
+// 在带 NEON 的目标上编译时（定义 __ARM_NEON）同时检查 Blend4444x8
+#include "blend4444.hpp"
+#include "test_common.hpp"
+#include <vector>
+
+// 参考实现：按公式逐通道计算
+static uint16_t Reference(uint16_t bg, uint16_t fg) {
+    uint32_t a = fg >> 12;
+    uint16_t out = 0;
+    for (int shift = 0; shift < 12; shift += 4) {
+        uint32_t f = (fg >> shift) & 0xF;
+        uint32_t b = (bg >> shift) & 0xF;
+        out |= (uint16_t)(((f * a + b * (15 - a)) / 15) << shift);
+    }
+    uint32_t outA = a + (bg >> 12);
+    return out | (uint16_t)((outA > 15 ? 15 : outA) << 12);
+}
+
+// 一个像素的三个颜色通道取不同的值，每个通道都覆盖 0..15
+static uint16_t MakePixel(uint32_t value, uint32_t alpha) {
+    return (uint16_t)(value | ((value ^ 5) << 4) | ((15 - value) << 8) | (alpha << 12));
+}
+
+// 所有 (前景值, 前景 alpha, 背景值, 背景 alpha) 组合，共 65536 对像素
+static void BuildPairs(std::vector<uint16_t>& bg, std::vector<uint16_t>& fg) {
+    for (uint32_t fa = 0; fa < 16; fa++)
+        for (uint32_t fv = 0; fv < 16; fv++)
+            for (uint32_t ba = 0; ba < 16; ba++)
+                for (uint32_t bv = 0; bv < 16; bv++) {
+                    fg.push_back(MakePixel(fv, fa));
+                    bg.push_back(MakePixel(bv, ba));
+                }
+}
+
+static void TestDiv15() {
+    for (uint32_t n = 0; n <= 225; n++) CHECK(Div15(n) == n / 15);
+}
+
+static void TestScalar() {
+    std::vector<uint16_t> bg, fg;
+    BuildPairs(bg, fg);
+    
+    int mismatches = 0;
+    for (size_t i = 0; i < bg.size(); i++) {
+        if (Blend4444(bg[i], fg[i]) != Reference(bg[i], fg[i])) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+#if defined(__ARM_NEON)
+static void TestNeon() {
+    std::vector<uint16_t> bg, fg;
+    BuildPairs(bg, fg);
+    
+    int mismatches = 0;
+    for (size_t i = 0; i < bg.size(); i += 8) {
+        uint16_t out[8];
+        vst1q_u16(out, Blend4444x8(vld1q_u16(&bg[i]), vld1q_u16(&fg[i])));
+        for (int j = 0; j < 8; j++) {
+            if (out[j] != Reference(bg[i + j], fg[i + j])) mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+#endif
+
+// 行混合：长度不是 8 的倍数，尾部走标量路径
+static void TestRow() {
+    std::vector<uint16_t> bg, fg;
+    BuildPairs(bg, fg);
+    const uint32_t count = (uint32_t)bg.size() - 3;
+    
+    std::vector<uint16_t> row(bg.begin(), bg.begin() + count);
+    Blend4444Row(row.data(), fg.data(), count);
+    
+    int mismatches = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (row[i] != Reference(bg[i], fg[i])) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+// 同一颜色的行混合：每种前景颜色叠加到所有背景上
+static void TestRowSolid() {
+    std::vector<uint16_t> backgrounds;
+    for (uint32_t ba = 0; ba < 16; ba++)
+        for (uint32_t bv = 0; bv < 16; bv++) backgrounds.push_back(MakePixel(bv, ba));
+    backgrounds.resize(backgrounds.size() - 5);
+    
+    int mismatches = 0;
+    for (uint32_t fa = 0; fa < 16; fa++) {
+        for (uint32_t fv = 0; fv < 16; fv++) {
+            uint16_t fg = MakePixel(fv, fa);
+            std::vector<uint16_t> row = backgrounds;
+            Blend4444RowSolid(row.data(), fg, (uint32_t)row.size());
+            for (size_t i = 0; i < row.size(); i++) {
+                if (row[i] != Reference(backgrounds[i], fg)) mismatches++;
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+int main() {
+    TestDiv15();
+    TestScalar();
+#if defined(__ARM_NEON)
+    TestNeon();
+#endif
+    TestRow();
+    TestRowSolid();
+    return TEST_RESULT();
+}
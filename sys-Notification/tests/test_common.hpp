@@ -0,0 +1,18 @@
+// 主机测试公共部分：CHECK 失败时打印位置并计数，main 返回失败数
+#pragma once
+
+#include <cstdio>
+
+extern void* g_HostFramebuffer;  // framebufferBegin 返回的缓冲（libnx_stub.cpp）
+extern unsigned g_HostFsCalls;   // fs 函数的调用次数，真机上每次是一次 IPC（fs_stub.cpp）
+
+static int g_TestFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        g_TestFailures++; \
+    } \
+} while (0)
+
+#define TEST_RESULT() (printf("%s: %s\n", __FILE__, g_TestFailures ? "FAILED" : "ok"), g_TestFailures ? 1 : 0)
@@ -0,0 +1,80 @@
+// LayerAnimator 的帧序列：用记录桩代替 VI 图层，每次等待垂直同步时间前进一帧
+#include "layer_animator.hpp"
+#include "test_common.hpp"
+#include <vector>
+
+#define FRAME_NS 16666667ULL
+
+// 记录桩：记录每次设置的位置，可以在第 failAt 次调用时返回错误
+class RecordingLayerControl : public LayerControl {
+public:
+    std::vector<float> xs;
+    std::vector<float> ys;
+    uint32_t vsyncs = 0;
+    int failAt = -1;
+    
+    uint32_t SetPosition(float x, float y) override {
+        if ((int)xs.size() == failAt) return 0x1234;
+        xs.push_back(x);
+        ys.push_back(y);
+        return 0;
+    }
+    void WaitVsync() override { vsyncs++; }
+    uint64_t GetTimeNs() override { return 1000000000ULL + vsyncs * FRAME_NS; }
+};
+
+int main() {
+    // 1. 从右向左滑入：第一帧在起点，单调逼近终点，最后一帧正好在终点
+    {
+        RecordingLayerControl control;
+        LayerAnimator animator(control);
+        CHECK(animator.PrepareSlide(1920, 75) == 0);
+        CHECK(animator.Slide(1920, 1221, 75, 250) == 0);
+        
+        CHECK(control.xs.size() == 17);          // 起点 + 250ms 内 15 帧 + 终点
+        CHECK(control.xs[0] == 1920);            // PrepareSlide
+        CHECK(control.xs[1] == 1920);            // 第一帧（进度 0）
+        CHECK(control.xs.back() == 1221);
+        for (size_t i = 1; i < control.xs.size(); i++) {
+            CHECK(control.xs[i] <= control.xs[i - 1]);
+            CHECK(control.ys[i] == 75);
+        }
+        
+        // 每次设置位置后等待一次垂直同步（开始前额外一次）
+        CHECK(control.vsyncs == control.xs.size());
+    }
+    
+    // 2. 从左向右滑入
+    {
+        RecordingLayerControl control;
+        LayerAnimator animator(control);
+        CHECK(animator.Slide(-549, 75, 75, 250) == 0);
+        CHECK(control.xs.front() == -549);
+        CHECK(control.xs.back() == 75);
+        for (size_t i = 1; i < control.xs.size(); i++) CHECK(control.xs[i] >= control.xs[i - 1]);
+    }
+    
+    // 3. 时长为 0：直接落到终点
+    {
+        RecordingLayerControl control;
+        LayerAnimator animator(control);
+        CHECK(animator.Slide(0, 100, 75, 0) == 0);
+        CHECK(control.xs.size() == 1 && control.xs[0] == 100);
+    }
+    
+    // 4. 图层调用失败：立即返回错误，不再继续设置位置
+    {
+        RecordingLayerControl control;
+        control.failAt = 3;
+        LayerAnimator animator(control);
+        CHECK(animator.Slide(1920, 1221, 75, 250) == 0x1234);
+        CHECK(control.xs.size() == 3);
+    }
+    
+    // 5. 缓动函数：端点固定且单调
+    CHECK(LayerAnimator::EaseOutCubic(0.0f) == 0.0f);
+    CHECK(LayerAnimator::EaseOutCubic(1.0f) == 1.0f);
+    for (int i = 1; i <= 100; i++) CHECK(LayerAnimator::EaseOutCubic(i / 100.0f) >= LayerAnimator::EaseOutCubic((i - 1) / 100.0f));
+    
+    return TEST_RESULT();
+}
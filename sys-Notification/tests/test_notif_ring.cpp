@@ -0,0 +1,144 @@
+// notif_ring 多生产者压力测试：多个线程同时写入，消费者按系统模块的方式取出、休眠、关闭和重新开放
+// 检查每条记录恰好取出一次、同一生产者的记录保持顺序、内容完整、没有丢失唤醒
+#define LIBNOTIFICATION_PROTOCOL_ONLY
+#include "libnotification.h"
+#include "test_common.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define PRODUCERS       6
+#define RECORDS_EACH    50000
+#define CLOSE_EVERY     5000      // 消费者每取出这么多条记录关闭并重新开放一次环
+
+// 记录内容：生产者编号、序号，其余字节由两者推出，用于检查写入是否完整
+struct TestRecord {
+    uint32_t producer;
+    uint32_t sequence;
+    uint8_t fill[NOTIF_RING_RECORD_SIZE - 8];
+};
+
+static_assert(sizeof(TestRecord) == NOTIF_RING_RECORD_SIZE, "record size");
+
+static void FillRecord(TestRecord& record, uint32_t producer, uint32_t sequence) {
+    record.producer = producer;
+    record.sequence = sequence;
+    for (size_t i = 0; i < sizeof(record.fill); i++) record.fill[i] = (uint8_t)(producer * 31 + sequence + i);
+}
+
+static bool RecordIntact(const TestRecord& record) {
+    TestRecord expected;
+    FillRecord(expected, record.producer, record.sequence);
+    return memcmp(&record, &expected, sizeof(record)) == 0;
+}
+
+// 自动清除的唤醒事件（对应系统模块的 Event）
+class WakeEvent {
+public:
+    void Signal() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Signaled = true;
+        m_Cond.notify_one();
+    }
+    
+    bool Wait(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        bool signaled = m_Cond.wait_for(lock, timeout, [this] { return m_Signaled; });
+        m_Signaled = false;
+        return signaled;
+    }
+    
+private:
+    std::mutex m_Mutex;
+    std::condition_variable m_Cond;
+    bool m_Signaled = false;
+};
+
+int main() {
+    static NotifRing ring;
+    notif_ring_init(&ring);
+    CHECK(notif_ring_valid(&ring));
+    
+    WakeEvent wake;
+    std::atomic<uint32_t> fullCount(0), closedCount(0), wakeCount(0);
+    
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&, p] {
+            for (uint32_t seq = 0; seq < RECORDS_EACH; seq++) {
+                TestRecord record;
+                FillRecord(record, p, seq);
+                
+                // 已满或已关闭时重试同一条记录（客户端此时会回退到 IPC 或文件投递）
+                for (;;) {
+                    bool needWake = false;
+                    NotifRingPushResult res = notif_ring_push(&ring, &record, &needWake);
+                    if (res == NOTIF_RING_PUSHED) {
+                        if (needWake) {
+                            wakeCount++;
+                            wake.Signal();
+                        }
+                        break;
+                    }
+                    if (res == NOTIF_RING_FULL) fullCount++;
+                    else closedCount++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    // 消费者：取出记录，环为空时按 prepare_wait 协议休眠，定期关闭并重新开放
+    std::vector<uint32_t> nextSequence(PRODUCERS, 0);
+    uint32_t received = 0, lostWakeups = 0, corrupted = 0, outOfOrder = 0;
+    const uint32_t total = PRODUCERS * RECORDS_EACH;
+    
+    while (received < total) {
+        const void* data;
+        while ((data = notif_ring_front(&ring)) != nullptr) {
+            TestRecord record;
+            memcpy(&record, data, sizeof(record));
+            notif_ring_pop(&ring);
+            
+            if (!RecordIntact(record) || record.producer >= PRODUCERS) {
+                corrupted++;
+            } else {
+                if (record.sequence != nextSequence[record.producer]) outOfOrder++;
+                nextSequence[record.producer] = record.sequence + 1;
+            }
+            
+            if (++received % CLOSE_EVERY == 0) {
+                // 与 RingTransport::Stop/Start 相同：关闭、等待写入中的记录发布，关闭一段时间后重新开放
+                notif_ring_close(&ring);
+                while (!notif_ring_settled(&ring)) std::this_thread::yield();
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                notif_ring_reopen(&ring);
+            }
+        }
+        
+        if (received >= total) break;
+        if (!notif_ring_prepare_wait(&ring)) continue;
+        
+        // 环为空时休眠：有新记录时生产者必须唤醒，超时后环非空说明唤醒丢失
+        if (!wake.Wait(std::chrono::milliseconds(2000)) && notif_ring_front(&ring) != nullptr) lostWakeups++;
+        notif_ring_cancel_wait(&ring);
+    }
+    
+    for (auto& t : producers) t.join();
+    
+    CHECK(received == total);
+    CHECK(corrupted == 0);
+    CHECK(outOfOrder == 0);
+    CHECK(lostWakeups == 0);
+    for (uint32_t p = 0; p < PRODUCERS; p++) CHECK(nextSequence[p] == RECORDS_EACH);
+    CHECK(notif_ring_front(&ring) == nullptr);
+    CHECK(notif_ring_size(&ring) == 0);
+    
+    printf("test_notif_ring: %u records, %u full, %u closed, %u wakeups\n",
+           received, fullCount.load(), closedCount.load(), wakeCount.load());
+    return TEST_RESULT();
+}
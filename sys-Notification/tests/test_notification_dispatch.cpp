@@ -0,0 +1,95 @@
+// 通过 LoopbackTransport 驱动完整的请求流程：校验、分发、接收者的返回值原样传回
+#include "notification_dispatch.hpp"
+#include "test_common.hpp"
+#include <cstring>
+#include <vector>
+
+// 记录桩：记录收到的请求，返回预设的结果码
+class RecordingSink : public NotificationSink {
+public:
+    std::vector<NotifPostRequest> posted;
+    uint32_t result = 0;
+    
+    uint32_t Post(const NotifPostRequest& request) override {
+        posted.push_back(request);
+        return result;
+    }
+};
+
+static NotifPostRequest MakeRequest(const char* text, uint32_t type, uint32_t position, uint32_t duration) {
+    NotifPostRequest request;
+    memset(&request, 0, sizeof(request));
+    strncpy(request.text, text, sizeof(request.text) - 1);
+    request.type = type;
+    request.position = position;
+    request.duration = duration;
+    return request;
+}
+
+int main() {
+    // 1. 有效请求原样交给接收者
+    {
+        RecordingSink sink;
+        NotificationDispatcher dispatcher(sink);
+        LoopbackTransport transport(dispatcher);
+        CHECK(transport.Start() == 0);
+        
+        NotifPostRequest request = MakeRequest("Hello", 1, 2, 3);
+        CHECK(transport.Post(request) == 0);
+        CHECK(sink.posted.size() == 1);
+        CHECK(strcmp(sink.posted[0].text, "Hello") == 0);
+        CHECK(sink.posted[0].type == 1);
+        CHECK(sink.posted[0].position == 2);
+        CHECK(sink.posted[0].duration == 3);
+        transport.Stop();
+    }
+    
+    // 2. 接收者的错误码（队列已满）原样返回，客户端据此回退
+    {
+        RecordingSink sink;
+        sink.result = NOTIF_RESULT_QUEUE_FULL;
+        NotificationDispatcher dispatcher(sink);
+        LoopbackTransport transport(dispatcher);
+        CHECK(transport.Post(MakeRequest("Full", 0, 0, 1)) == NOTIF_RESULT_QUEUE_FULL);
+        CHECK(sink.posted.size() == 1);
+    }
+    
+    // 3. 空文本和没有 '\0' 结尾的文本被拒绝，不交给接收者
+    {
+        RecordingSink sink;
+        NotificationDispatcher dispatcher(sink);
+        LoopbackTransport transport(dispatcher);
+        
+        CHECK(transport.Post(MakeRequest("", 0, 0, 1)) == NOTIF_RESULT_INVALID_ARG);
+        
+        NotifPostRequest request = MakeRequest("x", 0, 0, 1);
+        memset(request.text, 'A', sizeof(request.text));
+        CHECK(transport.Post(request) == NOTIF_RESULT_INVALID_ARG);
+        CHECK(sink.posted.empty());
+    }
+    
+    // 4. 未知命令和过短的负载
+    {
+        RecordingSink sink;
+        NotificationDispatcher dispatcher(sink);
+        NotifPostRequest request = MakeRequest("Hi", 0, 0, 1);
+        
+        CHECK(dispatcher.Dispatch(NOTIF_CMD_OPEN_RING, &request, sizeof(request)) == NOTIF_RESULT_UNKNOWN_CMD);
+        CHECK(dispatcher.Dispatch(42, &request, sizeof(request)) == NOTIF_RESULT_UNKNOWN_CMD);
+        CHECK(dispatcher.Dispatch(NOTIF_CMD_POST, &request, sizeof(request) - 1) == NOTIF_RESULT_INVALID_ARG);
+        CHECK(dispatcher.Dispatch(NOTIF_CMD_POST, nullptr, sizeof(request)) == NOTIF_RESULT_INVALID_ARG);
+        CHECK(sink.posted.empty());
+        
+        // 负载比请求体长（CMIF 填充）时只取请求体
+        unsigned char padded[sizeof(request) + 16] = {};
+        memcpy(padded, &request, sizeof(request));
+        CHECK(dispatcher.Dispatch(NOTIF_CMD_POST, padded, sizeof(padded)) == 0);
+        CHECK(sink.posted.size() == 1);
+    }
+    
+    // 5. 错误码与 libnx MAKERESULT(251, desc) 的编码一致
+    CHECK(NOTIF_RESULT_INVALID_ARG == (251u | (1u << 9)));
+    CHECK(NOTIF_RESULT_UNAVAILABLE == (251u | (4u << 9)));
+    
+    return TEST_RESULT();
+}
@@ -0,0 +1,141 @@
+// PanelCache：完整键比较（哈希冲突不串面板）、SD 卡文件数上限、SD 卡写入推迟到 FlushPending
+#include "panel_cache.hpp"
+#include "test_common.hpp"
+#include <dirent.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#define PIXELS 64
+
+// 用 seed 生成一块可压缩的面板
+static void MakePanel(u16* pixels, u32 seed) {
+    for (u32 i = 0; i < PIXELS; i++) pixels[i] = (u16)(seed + i / 16);
+}
+
+// 目录中 panel_*.bin 文件数
+static int CountPanelFiles(const char* dir) {
+    int count = 0;
+    DIR* d = opendir(dir);
+    if (!d) return -1;
+    while (struct dirent* e = readdir(d)) {
+        if (strncmp(e->d_name, "panel_", 6) == 0) count++;
+    }
+    closedir(d);
+    return count;
+}
+
+// 暴力寻找两个哈希相同的不同文本（32 位哈希，生日界约 2^16 次）
+static bool FindCollision(std::string& a, std::string& b) {
+    std::unordered_map<u32, std::string> seen;
+    char text[32];
+    for (u32 i = 0; i < 2000000; i++) {
+        snprintf(text, sizeof(text), "msg %u", i);
+        PanelKey key;
+        PanelCache::MakeKey(key, text, 0, 1, 2);
+        auto it = seen.find(key.hash);
+        if (it != seen.end()) {
+            a = it->second;
+            b = text;
+            return true;
+        }
+        seen.emplace(key.hash, text);
+    }
+    return false;
+}
+
+int main() {
+    u16 in[PIXELS], out[PIXELS];
+    
+    // 1. 哈希相同的两个通知：内存缓存和 SD 卡都不能互相命中
+    {
+        std::string textA, textB;
+        CHECK(FindCollision(textA, textB));
+        
+        char dir[] = "/tmp/panel_cache_test_XXXXXX";
+        CHECK(mkdtemp(dir) != nullptr);
+        
+        PanelKey keyA, keyB;
+        CHECK(PanelCache::MakeKey(keyA, textA.c_str(), 0, 1, 2));
+        CHECK(PanelCache::MakeKey(keyB, textB.c_str(), 0, 1, 2));
+        CHECK(keyA.hash == keyB.hash);
+        CHECK(!PanelCache::SameKey(keyA, keyB));
+        
+        {
+            PanelCache cache;
+            cache.SetDirectory(dir);
+            MakePanel(in, 100);
+            cache.Store(keyA, in, PIXELS);
+            CHECK(CountPanelFiles(dir) == 0);            // Store 不写 SD 卡
+            
+            CHECK(!cache.Fetch(keyB, out, PIXELS));      // 内存
+            CHECK(cache.Fetch(keyA, out, PIXELS));
+            CHECK(memcmp(in, out, sizeof(in)) == 0);
+            
+            cache.FlushPending();
+            CHECK(CountPanelFiles(dir) == 1);
+            cache.FlushPending();                         // 已写入的不再重复写入
+            CHECK(CountPanelFiles(dir) == 1);
+            CHECK(cache.GetHits() == 1 && cache.GetMisses() == 1);
+        }
+        {
+            PanelCache cache;                             // 新实例只能从 SD 卡读取
+            cache.SetDirectory(dir);
+            CHECK(!cache.Fetch(keyB, out, PIXELS));      // SD 卡同一槽位
+            CHECK(cache.Fetch(keyA, out, PIXELS));
+            CHECK(memcmp(in, out, sizeof(in)) == 0);
+        }
+        
+        // 类型、样式、字体不同也不命中
+        PanelKey other;
+        PanelCache::MakeKey(other, textA.c_str(), 1, 1, 2);
+        CHECK(!PanelCache::SameKey(keyA, other));
+        
+        std::string cmd = std::string("rm -rf ") + dir;
+        CHECK(system(cmd.c_str()) == 0);
+    }
+    
+    // 2. SD 卡文件数不超过槽位数，最近写入的面板可以读回
+    {
+        char dir[] = "/tmp/panel_cache_test_XXXXXX";
+        CHECK(mkdtemp(dir) != nullptr);
+        
+        PanelCache cache;
+        cache.SetDirectory(dir);
+        char text[32];
+        for (u32 i = 0; i < PANEL_CACHE_SD_SLOTS * 4; i++) {
+            snprintf(text, sizeof(text), "notification %u", i);
+            PanelKey key;
+            PanelCache::MakeKey(key, text, 0, 1, 2);
+            MakePanel(in, i);
+            cache.Store(key, in, PIXELS);
+            cache.FlushPending();
+        }
+        CHECK(CountPanelFiles(dir) > 0);
+        CHECK(CountPanelFiles(dir) <= PANEL_CACHE_SD_SLOTS);
+        
+        PanelCache reload;
+        reload.SetDirectory(dir);
+        PanelKey last;
+        snprintf(text, sizeof(text), "notification %u", PANEL_CACHE_SD_SLOTS * 4 - 1);
+        PanelCache::MakeKey(last, text, 0, 1, 2);
+        CHECK(reload.Fetch(last, out, PIXELS));
+        MakePanel(in, PANEL_CACHE_SD_SLOTS * 4 - 1);
+        CHECK(memcmp(in, out, sizeof(in)) == 0);
+        
+        std::string cmd = std::string("rm -rf ") + dir;
+        CHECK(system(cmd.c_str()) == 0);
+    }
+    
+    // 3. 过长的文本不生成键
+    {
+        char text[PANEL_KEY_TEXT_MAX + 1];
+        memset(text, 'a', sizeof(text) - 1);
+        text[sizeof(text) - 1] = '\0';
+        PanelKey key;
+        CHECK(!PanelCache::MakeKey(key, text, 0, 1, 2));
+    }
+    
+    return TEST_RESULT();
+}
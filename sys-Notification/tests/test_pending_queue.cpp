@@ -0,0 +1,144 @@
+// PendingQueue 的投递顺序：用桩代替目录扫描，按任意顺序给出文件名
+// 带序号的文件名按 (时钟, 进程ID, 计数) 的数值排序，旧版文件名按修改时间排在前面
+#include "pending_queue.hpp"
+#include "SimpleFs.hpp"
+#include "test_common.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 桩目录：文件名和修改时间
+struct StubFile {
+    const char* name;
+    uint64_t mtime;
+};
+
+static std::vector<StubFile> s_Files;
+static bool s_HasTemp = false;
+
+bool SimpleFs::ScanNotificationFiles(const char* dir_path, NotificationFileCallback callback, void* user, bool* has_temp) {
+    (void)dir_path;
+    for (const StubFile& file : s_Files) callback(file.name, user);
+    if (has_temp) *has_temp = s_HasTemp;
+    return true;
+}
+
+uint64_t SimpleFs::GetModifiedTime(const char* file_path) {
+    const char* name = strrchr(file_path, '/');
+    name = name ? name + 1 : file_path;
+    for (const StubFile& file : s_Files) {
+        if (strcmp(file.name, name) == 0) return file.mtime;
+    }
+    return 0;
+}
+
+// 扫描后按队列顺序取出全部文件名
+static std::vector<std::string> Drain(PendingQueue& queue) {
+    std::vector<std::string> names;
+    while (const char* path = queue.Front()) {
+        CHECK(strncmp(path, "/dir/", 5) == 0);
+        names.push_back(path + 5);
+        queue.Pop();
+    }
+    return names;
+}
+
+int main() {
+    // 1. 带序号的文件名：时钟优先，其次进程ID、计数，按数值而不是字符串比较
+    {
+        s_Files = {
+            { "notif_0000000000000200_a_0.ntf", 0 },
+            { "notif_0000000000000100_10_1.ntf", 0 },
+            { "notif_0000000000000100_a_a.ntf", 0 },   // 计数 10 在 9 之后
+            { "notif_0000000000000100_a_9.ntf", 0 },
+            { "notif_0000000000000100_10_0.ntf", 0 },  // 进程ID 0x10 在 0xa 之后
+            { "notif_00000000000000FF_ff_0.ntf", 0 },  // 大写十六进制
+        };
+        s_HasTemp = false;
+        
+        PendingQueue queue;
+        CHECK(queue.Scan("/dir") == 6);
+        CHECK(!queue.NeedsRescan());
+        
+        std::vector<std::string> expected = {
+            "notif_00000000000000FF_ff_0.ntf",
+            "notif_0000000000000100_a_9.ntf",
+            "notif_0000000000000100_a_a.ntf",
+            "notif_0000000000000100_10_0.ntf",
+            "notif_0000000000000100_10_1.ntf",
+            "notif_0000000000000200_a_0.ntf",
+        };
+        CHECK(Drain(queue) == expected);
+        CHECK(queue.Empty());
+    }
+    
+    // 2. 旧版文件名与带序号的混合：旧版全部排在前面，按修改时间、再按文件名
+    //    格式不完整的序号文件名（缺计数、时钟超过 64 位、计数超过 32 位）按旧版处理
+    {
+        s_Files = {
+            { "notif_0000000000000001_1_0.ntf", 1 },
+            { "notif_k3j2.ini", 300 },
+            { "notif_0000000000000002_1_0.ini", 1 },   // 带序号的旧扩展名
+            { "notif_a1b2.ini", 100 },
+            { "notif_12_34.ntf", 200 },                // 缺计数
+            { "notif_00000000000000001_1_0.ntf", 200 },// 时钟 17 位
+            { "notif_1_1_100000000.ntf", 50 },         // 计数超过 32 位
+            { "notif_zz.ini", 100 },
+        };
+        
+        PendingQueue queue;
+        CHECK(queue.Scan("/dir") == 8);
+        
+        std::vector<std::string> expected = {
+            "notif_1_1_100000000.ntf",
+            "notif_a1b2.ini",
+            "notif_zz.ini",
+            "notif_00000000000000001_1_0.ntf",
+            "notif_12_34.ntf",
+            "notif_k3j2.ini",
+            "notif_0000000000000001_1_0.ntf",
+            "notif_0000000000000002_1_0.ini",
+        };
+        CHECK(Drain(queue) == expected);
+    }
+    
+    // 3. 文件数超出队列：保留最早的 PENDING_QUEUE_SIZE 个，并要求再次扫描
+    {
+        std::vector<std::string> names;
+        for (int i = PENDING_QUEUE_SIZE + 4; i > 0; i--) {
+            char name[PENDING_NAME_MAX];
+            snprintf(name, sizeof(name), "notif_%016x_1_0.ntf", i);
+            names.push_back(name);
+        }
+        s_Files.clear();
+        for (const std::string& name : names) s_Files.push_back({ name.c_str(), 0 });
+        s_Files.push_back({ "notif_legacy.ini", 999 });
+        
+        PendingQueue queue;
+        CHECK(queue.Scan("/dir") == PENDING_QUEUE_SIZE);
+        CHECK(queue.NeedsRescan());
+        
+        std::vector<std::string> drained = Drain(queue);
+        CHECK(drained.size() == PENDING_QUEUE_SIZE);
+        CHECK(drained[0] == "notif_legacy.ini");
+        for (int i = 1; i < PENDING_QUEUE_SIZE; i++) {
+            char name[PENDING_NAME_MAX];
+            snprintf(name, sizeof(name), "notif_%016x_1_0.ntf", i);
+            CHECK(drained[i] == name);
+        }
+    }
+    
+    // 4. 有写入中的临时文件时要求再次扫描；文件名过长的不收集
+    {
+        std::string longName = "notif_" + std::string(PENDING_NAME_MAX, 'a') + ".ini";
+        s_Files = { { longName.c_str(), 0 }, { "notif_0000000000000001_1_0.ntf", 0 } };
+        s_HasTemp = true;
+        
+        PendingQueue queue;
+        CHECK(queue.Scan("/dir") == 1);
+        CHECK(queue.NeedsRescan());
+        s_HasTemp = false;
+    }
+    
+    return TEST_RESULT();
+}
@@ -0,0 +1,190 @@
+// 块线性按 GOB 写入（FillSpanRect / BlendSpanRect / GetGobOffset）与逐像素 GetPixelOffset 写入的等价性，
+// 以及线性合成（EndFrame 时 SwizzleBlit）与直接写入帧缓冲的等价性、裁剪栈超出深度时的行为
+#include "graphics.hpp"
+#include "test_common.hpp"
+#include <cstdlib>
+#include <cstring>
+
+// 面板帧缓冲尺寸（宽度对齐到 32），高度按块高度 128 行分配
+#define FB_W 416
+#define FB_H 100
+#define FB_ALLOC_H 128
+
+static u16 s_Span[FB_W * FB_ALLOC_H];
+static u16 s_Pixel[FB_W * FB_ALLOC_H];
+static u16 s_Linear[FB_W * FB_H];
+
+// RGBA4444 -> Color
+static Color ToColor(u16 raw) {
+    return {(u8)(raw & 0xF), (u8)((raw >> 4) & 0xF), (u8)((raw >> 8) & 0xF), (u8)(raw >> 12)};
+}
+
+// 在 buffer 上开始一帧（framebufferBegin 返回 buffer）
+static void Begin(GraphicsRenderer& g, u16* buffer) {
+    g_HostFramebuffer = buffer;
+    g.StartFrame();
+}
+
+// 用 SetPixel / SetPixelBlend 逐像素绘制同一个矩形（作为参考）
+static void ReferenceRect(GraphicsRenderer& g, s32 x, s32 y, s32 w, s32 h, Color c) {
+    for (s32 py = y; py < y + h; py++) {
+        for (s32 px = x; px < x + w; px++) {
+            if (c.a == 0xF) g.SetPixel(px, py, c);
+            else g.SetPixelBlend(px, py, c);
+        }
+    }
+}
+
+// 两个缓冲填上相同的随机内容
+static void RandomFill() {
+    for (u32 i = 0; i < FB_W * FB_ALLOC_H; i++) s_Span[i] = (u16)rand();
+    memcpy(s_Pixel, s_Span, sizeof(s_Span));
+}
+
+int main() {
+    static Framebuffer fb;
+    static Event vsync;
+    GraphicsRenderer g;
+    g.Bind(&fb, &vsync, FB_W, FB_H);
+    srand(1);
+    
+    // 1. 逐像素地址互不重叠：屏幕内每个像素都写到不同位置
+    {
+        memset(s_Pixel, 0, sizeof(s_Pixel));
+        Begin(g, s_Pixel);
+        for (s32 y = 0; y < FB_H; y++) {
+            for (s32 x = 0; x < FB_W; x++) {
+                g.SetPixel(x, y, ToColor(0xFFFF));
+            }
+        }
+        g.EndFrame();
+        
+        u32 written = 0;
+        for (u32 i = 0; i < FB_W * FB_ALLOC_H; i++) written += (s_Pixel[i] == 0xFFFF);
+        CHECK(written == FB_W * FB_H);
+    }
+    
+    // 2. 不透明矩形（FillSpanRect，含整块 GOB、8 像素段和边缘像素）与逐像素写入一致
+    for (int i = 0; i < 2000; i++) {
+        s32 x = rand() % (FB_W + 80) - 40;
+        s32 y = rand() % (FB_H + 40) - 20;
+        s32 w = rand() % 200;
+        s32 h = rand() % 80;
+        Color c = ToColor((u16)(rand() | 0xF000));
+        
+        RandomFill();
+        Begin(g, s_Span);
+        g.DrawRect(x, y, w, h, c);
+        g.EndFrame();
+        Begin(g, s_Pixel);
+        ReferenceRect(g, x, y, w, h, c);
+        g.EndFrame();
+        CHECK(memcmp(s_Span, s_Pixel, sizeof(s_Span)) == 0);
+    }
+    
+    // 3. 半透明矩形（BlendSpanRect）与逐像素 SetPixelBlend 一致
+    for (int i = 0; i < 2000; i++) {
+        s32 x = rand() % (FB_W + 80) - 40;
+        s32 y = rand() % (FB_H + 40) - 20;
+        s32 w = rand() % 200;
+        s32 h = rand() % 80;
+        Color c = ToColor((u16)(rand() % 0xF000));
+        
+        RandomFill();
+        Begin(g, s_Span);
+        g.DrawRect(x, y, w, h, c);
+        g.EndFrame();
+        Begin(g, s_Pixel);
+        ReferenceRect(g, x, y, w, h, c);
+        g.EndFrame();
+        CHECK(memcmp(s_Span, s_Pixel, sizeof(s_Span)) == 0);
+    }
+    
+    // 4. 整屏填充与逐像素写入一致（帧缓冲中屏幕外的部分不受影响）
+    {
+        Color c = {3, 7, 11, 15};
+        RandomFill();
+        Begin(g, s_Span);
+        g.FillScreen(c);
+        g.EndFrame();
+        Begin(g, s_Pixel);
+        ReferenceRect(g, 0, 0, FB_W, FB_H, c);
+        g.EndFrame();
+        CHECK(memcmp(s_Span, s_Pixel, sizeof(s_Span)) == 0);
+    }
+    
+    // 5. 线性合成：逐像素写入线性表面后由 SwizzleBlit 整体转换，与直接按 GetPixelOffset 写入帧缓冲一致
+    {
+        RandomFill();
+        g.BindLinearSurface(s_Linear);
+        g.EnableLinearComposition();
+        Begin(g, s_Span);
+        for (s32 y = 0; y < FB_H; y++) {
+            for (s32 x = 0; x < FB_W; x++) g.SetPixel(x, y, ToColor((u16)(y * FB_W + x)));
+        }
+        g.EndFrame();
+        g.DisableLinearComposition();
+        
+        Begin(g, s_Pixel);
+        for (s32 y = 0; y < FB_H; y++) {
+            for (s32 x = 0; x < FB_W; x++) g.SetPixel(x, y, ToColor((u16)(y * FB_W + x)));
+        }
+        g.EndFrame();
+        CHECK(memcmp(s_Span, s_Pixel, sizeof(s_Span)) == 0);
+    }
+    
+    // 6. 线性合成绘制的场景（整屏填充 + 随机矩形）与直接绘制到帧缓冲一致
+    for (int i = 0; i < 200; i++) {
+        s32 x = rand() % (FB_W + 80) - 40;
+        s32 y = rand() % (FB_H + 40) - 20;
+        s32 w = rand() % 200;
+        s32 h = rand() % 80;
+        Color c = ToColor((u16)rand());
+        
+        RandomFill();
+        g.EnableLinearComposition();
+        Begin(g, s_Span);
+        g.FillScreen({1, 2, 3, 15});
+        g.DrawRect(x, y, w, h, c);
+        g.EndFrame();
+        g.DisableLinearComposition();
+        
+        Begin(g, s_Pixel);
+        g.FillScreen({1, 2, 3, 15});
+        g.DrawRect(x, y, w, h, c);
+        g.EndFrame();
+        CHECK(memcmp(s_Span, s_Pixel, sizeof(s_Span)) == 0);
+    }
+    g.BindLinearSurface(nullptr);
+    
+    // 7. 裁剪栈超出深度：多出的 PushClip 不改变区域，对应的 PopClip 什么都不做
+    {
+        RandomFill();
+        Begin(g, s_Span);
+        g.FillScreen({1, 1, 1, 15});
+        g.PushClip(10, 10, 300, 80);
+        g.PushClip(20, 15, 200, 60);
+        g.PushClip(30, 20, 150, 40);
+        g.PushClip(40, 25, 100, 30);                  // 栈满
+        g.PushClip(50, 30, 10, 10);                   // 超出深度
+        g.PushClip(60, 35, 5, 5);
+        g.FillScreen({2, 2, 2, 15});                  // 仍是第 4 层区域
+        g.PopClip();
+        g.PopClip();
+        g.DrawRect(35, 22, 20, 20, {3, 3, 3, 15});    // 仍按第 4 层裁剪
+        for (int i = 0; i < CLIP_STACK_DEPTH; i++) g.PopClip();
+        g.PopClip();                                  // 多余的 PopClip 被忽略
+        g.DrawRect(0, 0, 5, 5, {4, 4, 4, 15});        // 恢复整个屏幕
+        g.EndFrame();
+        
+        Begin(g, s_Pixel);
+        g.FillScreen({1, 1, 1, 15});
+        g.DrawRect(40, 25, 100, 30, {2, 2, 2, 15});
+        g.DrawRect(40, 25, 15, 17, {3, 3, 3, 15});
+        g.DrawRect(0, 0, 5, 5, {4, 4, 4, 15});
+        g.EndFrame();
+        CHECK(memcmp(s_Span, s_Pixel, sizeof(s_Span)) == 0);
+    }
+    
+    return TEST_RESULT();
+}
@@ -0,0 +1,141 @@
+// SpoolJournal：部分确认、读完后改名轮转、轮转前追加的记录、残缺记录、重启时遗留的旧日志
+#include "spool_journal.hpp"
+#include "test_common.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::string s_Dir;
+static std::string s_Path;
+static std::string s_Rotated;
+
+static bool Exists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+// 按客户端的方式追加一条记录（_notif_spool_post）
+static void Append(const std::string& path, const char* text) {
+    NotifSpoolRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = NOTIF_SPOOL_MAGIC;
+    record.tick = 1;
+    strncpy(record.request.text, text, sizeof(record.request.text) - 1);
+    record.request.duration = 3;
+    record.checksum = notif_spool_checksum(&record);
+    
+    FILE* f = fopen(path.c_str(), "ab");
+    fwrite(&record, sizeof(record), 1, f);
+    fclose(f);
+}
+
+static void AppendGarbage(const std::string& path, size_t size) {
+    FILE* f = fopen(path.c_str(), "ab");
+    for (size_t i = 0; i < size; i++) fputc(0xA5, f);
+    fclose(f);
+}
+
+int main() {
+    char dir[] = "/tmp/test_spool_XXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    s_Dir = dir;
+    s_Path = s_Dir + "/spool.bin";
+    s_Rotated = s_Path + ".old";
+    
+    NotifPostRequest out[SPOOL_READ_RECORDS];
+    
+    // 1. 部分确认：未确认的记录下次再读出；全部确认后日志轮转并删除
+    {
+        SpoolJournal spool(s_Path.c_str());
+        CHECK(spool.Peek(out, 8) == 0);
+        CHECK(!spool.Refresh());
+        
+        const char* texts[] = { "a", "b", "c", "d", "e" };
+        for (const char* t : texts) Append(s_Path, t);
+        CHECK(spool.Refresh());
+        
+        CHECK(spool.Peek(out, 8) == 5);
+        spool.Consume(2);
+        CHECK(spool.HasPending());
+        
+        CHECK(spool.Peek(out, 8) == 3);
+        CHECK(strcmp(out[0].text, "c") == 0);
+        CHECK(strcmp(out[2].text, "e") == 0);
+        spool.Consume(0);
+        
+        CHECK(spool.Peek(out, 2) == 2);
+        CHECK(strcmp(out[0].text, "c") == 0);
+        spool.Consume(2);
+        CHECK(spool.Peek(out, 8) == 1);
+        CHECK(strcmp(out[0].text, "e") == 0);
+        spool.Consume(1);
+        
+        // 读完后改名轮转，旧日志没有新记录时直接删除
+        CHECK(!Exists(s_Path));
+        CHECK(!Exists(s_Rotated));
+        CHECK(!spool.Refresh());
+    }
+    
+    // 2. 读取后、轮转前追加的记录留在旧日志中，读完旧日志再读新日志
+    {
+        SpoolJournal spool(s_Path.c_str());
+        Append(s_Path, "1");
+        Append(s_Path, "2");
+        CHECK(spool.Peek(out, 8) == 2);
+        
+        Append(s_Path, "3");                 // 轮转前追加
+        spool.Consume(2);
+        CHECK(!Exists(s_Path));
+        CHECK(Exists(s_Rotated));
+        
+        Append(s_Path, "4");                 // 轮转后追加到新日志
+        CHECK(spool.Refresh());
+        CHECK(spool.Peek(out, 8) == 1);
+        CHECK(strcmp(out[0].text, "3") == 0);
+        spool.Consume(1);
+        CHECK(!Exists(s_Rotated));
+        
+        // 旧日志读完后新日志中的记录仍算未读
+        CHECK(spool.Refresh());
+        CHECK(spool.Peek(out, 8) == 1);
+        CHECK(strcmp(out[0].text, "4") == 0);
+        spool.Consume(1);
+        CHECK(!Exists(s_Path));
+        CHECK(!spool.Refresh());
+    }
+    
+    // 3. 中间的坏数据被跳过，前后的记录都读出
+    {
+        SpoolJournal spool(s_Path.c_str());
+        Append(s_Path, "x");
+        AppendGarbage(s_Path, 10);
+        Append(s_Path, "y");
+        CHECK(spool.Peek(out, 8) == 2);
+        CHECK(strcmp(out[0].text, "x") == 0);
+        CHECK(strcmp(out[1].text, "y") == 0);
+        spool.Consume(2);
+        CHECK(!spool.Refresh());
+    }
+    
+    // 4. 上次退出时遗留的旧日志在启动后先读
+    {
+        Append(s_Rotated, "old");
+        Append(s_Path, "new");
+        
+        SpoolJournal spool(s_Path.c_str());
+        CHECK(spool.Refresh());
+        CHECK(spool.Peek(out, 8) == 1);
+        CHECK(strcmp(out[0].text, "old") == 0);
+        spool.Consume(1);
+        CHECK(spool.Peek(out, 8) == 1);
+        CHECK(strcmp(out[0].text, "new") == 0);
+        spool.Consume(1);
+        CHECK(!Exists(s_Rotated));
+        CHECK(!Exists(s_Path));
+    }
+    
+    rmdir(s_Dir.c_str());
+    return TEST_RESULT();
+}
@@ -0,0 +1,86 @@
+// 文本遮罩：范围（由字形外框求出，不光栅化）等于所有字形位图与文本框交集的并集，
+// 用遮罩绘制与逐字形绘制结果相同；需要 NOTIF_TEST_FONT=<ttf 路径>，未设置时跳过
+#include "graphics.hpp"
+#include "font_manager.hpp"
+#include "test_common.hpp"
+#include <cstdlib>
+#include <cstring>
+
+#define FB_W 416
+#define FB_H 100
+
+static u16 s_Linear[FB_W * FB_H];
+static u16 s_Reference[FB_W * FB_H];
+
+// 用 RenderGlyph 的位图求遮罩范围（BuildTextMask 改用字形外框之前的做法）
+static void BitmapBounds(const TextLayout& layout, s32* outX0, s32* outY0, s32* outX1, s32* outY1) {
+    FontManager& fontMgr = FontManager::Instance();
+    s32 maskX0 = layout.x + layout.w, maskY0 = layout.y + layout.h, maskX1 = layout.x, maskY1 = layout.y;
+    for (u32 i = 0; i < layout.count; i++) {
+        const TextLayout::Glyph& g = layout.glyphs[i];
+        auto glyph = fontMgr.RenderGlyph(g.font, g.glyphIndex, layout.fontSize);
+        if (!glyph.data) continue;
+        
+        s32 x0 = g.penX + glyph.xoffset, y0 = layout.baselineY + glyph.yoffset;
+        s32 x1 = x0 + glyph.width, y1 = y0 + glyph.height;
+        if (x0 < layout.x) x0 = layout.x;
+        if (y0 < layout.y) y0 = layout.y;
+        if (x1 > layout.x + layout.w) x1 = layout.x + layout.w;
+        if (y1 > layout.y + layout.h) y1 = layout.y + layout.h;
+        if (x0 < x1 && y0 < y1) {
+            if (x0 < maskX0) maskX0 = x0;
+            if (y0 < maskY0) maskY0 = y0;
+            if (x1 > maskX1) maskX1 = x1;
+            if (y1 > maskY1) maskY1 = y1;
+        }
+        fontMgr.FreeGlyph(glyph);
+    }
+    *outX0 = maskX0; *outY0 = maskY0; *outX1 = maskX1; *outY1 = maskY1;
+}
+
+// 排版 text，检查遮罩范围和绘制结果
+static void CheckText(GraphicsRenderer& g, const char* text, s32 x, s32 y, s32 w, s32 h, float fontSize) {
+    static TextLayout layout;
+    const Color color = {5, 5, 5, 15};
+    g.LayoutText(layout, text, x, y, w, h, fontSize, GraphicsRenderer::TextAlign::LEFT);
+    CHECK(layout.count > 0);
+    
+    g.StartOffscreen();
+    g.FillScreen({0, 0, 0, 0});
+    g.DrawTextLayout(layout, 0, 0, color);
+    g.EndOffscreen();
+    memcpy(s_Reference, s_Linear, sizeof(s_Linear));
+    
+    s32 x0, y0, x1, y1;
+    BitmapBounds(layout, &x0, &y0, &x1, &y1);
+    CHECK(g.BuildTextMask(layout));
+    CHECK(layout.maskX == x0 && layout.maskY == y0);
+    CHECK(layout.maskW == x1 - x0 && layout.maskH == y1 - y0);
+    
+    g.StartOffscreen();
+    g.FillScreen({0, 0, 0, 0});
+    g.DrawTextLayout(layout, 0, 0, color);
+    g.EndOffscreen();
+    CHECK(memcmp(s_Reference, s_Linear, sizeof(s_Linear)) == 0);
+    
+    GraphicsRenderer::FreeTextMask(layout);
+    CHECK(layout.mask == nullptr);
+}
+
+int main() {
+    if (!getenv("NOTIF_TEST_FONT")) {
+        printf("test_text_mask: skipped (NOTIF_TEST_FONT not set)\n");
+        return 0;
+    }
+    
+    static Framebuffer fb;
+    static Event vsync;
+    GraphicsRenderer g;
+    g.Bind(&fb, &vsync, FB_W, FB_H);
+    g.BindLinearSurface(s_Linear);
+    
+    CheckText(g, "Sys-Notification 123", 70, 0, 331, FB_H, 28);
+    // 文本框比字形窄：遮罩裁剪到文本框
+    CheckText(g, "Clipped text that overflows", 20, 40, 120, 20, 28);
+    return TEST_RESULT();
+}